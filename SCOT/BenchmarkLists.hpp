@@ -37,6 +37,7 @@
 #include <vector>
 #include <algorithm>
 #include <random>
+#include <type_traits>
 #include "HarrisLinkedListNR.hpp"
 #include "HarrisLinkedListEBR.hpp"
 #include "HarrisLinkedListLFHP.hpp"
@@ -63,6 +64,22 @@
 #include "NatarajanMittalTreeEBR.hpp"
 #include "NatarajanMittalTreeIBR.hpp"
 #include "NatarajanMittalTreeHyaline.hpp"
+#include "HandOverHandLinkedList.hpp"
+#include "LazyLinkedListEBR.hpp"
+#include "LockedSet.hpp"
+#include "NodeArena.hpp"
+#include "PerfCounters.hpp"
+#include "KeyPolicy.hpp"
+#include "LatencyHistogram.hpp"
+#include "Stats.hpp"
+#include "KeyGenerator.hpp"
+#include "Topology.hpp"
+#include "TimeSeries.hpp"
+#include "Stall.hpp"
+#include "Trace.hpp"
+#include "Ycsb.hpp"
+#include "OpenLoop.hpp"
+#include "RetireDelay.hpp"
 #include <unistd.h>
 
 using namespace std;
@@ -74,9 +91,154 @@ enum DsType {
     DS_TYPE_TREE = 2
 };
 
+enum KeyType {
+    KEY_INT = 0,
+    KEY_STRING = 1,
+    KEY_ID128 = 2
+};
+
+/*
+ * Workload keys other than UserData. Keys are built from a sequence
+ * number, which is scrambled first so that neighbouring numbers do not
+ * share a prefix. The 16-digit hex prefix also keeps every string out
+ * of the small-string buffer, as with typical production keys.
+ */
+static inline uint64_t scrambleKey(long long seq) {
+    uint64_t x = (uint64_t) seq + 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+/*
+ * --keys=string:N pads every string key to N bytes. The padding follows
+ * the unique part, so it lengthens equal-key comparisons and the key
+ * objects, while ordering is still decided by the prefix. N may not be
+ * below the length of the longest unpadded key of the range.
+ */
+struct StringKey {
+    static const size_t MAX_LENGTH = 4096;
+
+    std::string str;
+
+    static size_t &length() {
+        static size_t n = 0;
+        return n;
+    }
+
+    // The unpadded length of key 'seq': 16 hex digits, ':' and 'seq'
+    static size_t natural(long long seq) { return 17 + std::to_string(seq).size(); }
+
+    // The longest unpadded key of the range, set with the range
+    static size_t &longest() {
+        static size_t n = 0;
+        return n;
+    }
+
+    StringKey() { }
+    StringKey(long long seq) {
+        char buf[48];
+        snprintf(buf, sizeof(buf), "%016llx:%lld", (unsigned long long) scrambleKey(seq), seq);
+        str = buf;
+        if (str.size() < length()) str.append(length() - str.size(), '.');
+    }
+
+    bool operator < (const StringKey& other) const { return str < other.str; }
+    bool operator == (const StringKey& other) const { return str == other.str; }
+};
+
+struct Id128Key {
+    uint64_t hi;
+    uint64_t lo;
+
+    Id128Key() : hi{0}, lo{0} { }
+    Id128Key(long long seq) : hi{scrambleKey(seq)}, lo{(uint64_t) seq} { }
+
+    bool operator < (const Id128Key& other) const {
+        return hi < other.hi || (hi == other.hi && lo < other.lo);
+    }
+    bool operator == (const Id128Key& other) const {
+        return hi == other.hi && lo == other.lo;
+    }
+};
+
+// The first 8 bytes, big-endian, so that integer order matches std::string order
+template<>
+struct KeyPolicy<StringKey> {
+    static const bool HAS_PREFIX = true;
+
+    static inline uint64_t prefix(const StringKey &key) {
+        uint64_t p = 0;
+        size_t len = std::min(key.str.size(), (size_t) 8);
+        for (size_t i = 0; i < 8; i++)
+            p = (p << 8) | (i < len ? (unsigned char) key.str[i] : 0);
+        return p;
+    }
+    static inline bool less(const StringKey &a, const StringKey &b) { return a < b; }
+    static inline bool equal(const StringKey &a, const StringKey &b) { return a == b; }
+};
+
+template<>
+struct KeyPolicy<Id128Key> {
+    static const bool HAS_PREFIX = true;
+
+    static inline uint64_t prefix(const Id128Key &key) { return key.hi; }
+    static inline bool less(const Id128Key &a, const Id128Key &b) { return a < b; }
+    static inline bool equal(const Id128Key &a, const Id128Key &b) { return a == b; }
+};
+
+// An operation mix of --roles and --phases
+struct OpMix {
+    int read, insert, remove, scan;         // percentages that add up to 100
+    std::string name;                       // read, write, scan, ... or the percentages
+};
+
+// A group of --roles: 'threads' consecutive threads with their own mix
+struct ThreadRole {
+    int threads;
+    OpMix mix;
+};
+
+// A step of --phases: all threads run 'mix' for 'seconds', or until the
+// structure holds 'until' keys if that comes first
+struct Phase {
+    static const int UNTIL_LIMIT = 60;      // seconds of an until=N phase given no S
+    int seconds;
+    long long until = -1;                   // -1: time only
+    OpMix mix;
+};
+
+struct BenchOptions {
+    int arenaMode = NodeArena::ARENA_OFF;   // --arena[=thp|hugetlb]
+    bool dtlb = false;                      // --dtlb
+    bool perf = false;                      // --perf
+    bool numa = false;                      // --numa
+    int keyType = KEY_INT;                  // --keys=int|string[:N]|id128
+    int latencySample = 0;                  // --latency[=N]: time every Nth operation
+    KeyDistribution::Config keyDist;        // --dist=...
+    double prefillRatio = -1;               // --prefill=R, -1: numElements/2 random draws
+    int sampleMs = 0;                       // --sample=MS[:path]
+    std::vector<int> oversub;               // --oversub=F[,F...]: F x online CPUs threads
+    std::vector<int> sweepMultiples;        // --sweep=M[,M...]: M x hardware threads on top of the topology sweep
+    std::string recordPath;                 // --record=path: trace of the first run
+    char ycsb = 0;                          // --ycsb=A..F
+    double rate = 0;                        // --rate=OPS: offered load of all threads, 0: closed loop
+    std::vector<ThreadRole> roles;          // --roles=N:MIX[,N:MIX...]
+    std::vector<Phase> phases;              // --phases=MIX:S[,MIX:S...]
+    bool baselines = false;                 // --baselines
+    double ciTarget = 0;                    // --ci=PCT[:MAX]: 95% CI half-width as % of the mean, 0: fixed runs
+    int ciMaxRuns = 30;                     // --ci=PCT:MAX
+    bool bulkLoad = false;                  // --bulkload
+    int arrivals = OpenLoop::ARRIVALS_POISSON; // --arrivals=poisson|constant
+    std::string samplePath = "timeseries.csv";
+};
+
 class BenchmarkLists {
 
 private:
+    // HP_MAX_THREADS and HE_MAX_THREADS
+    static const int MAX_BENCH_THREADS = 384;
+
     struct UserData  {
         long long seq;
         UserData(long long lseq) {
@@ -123,17 +285,91 @@ private:
 
     static const long long NSEC_IN_SEC = 1000000000LL;
 
+    enum LatencyKind {
+        LAT_SEARCH = 0,
+        LAT_INSERT = 1,
+        LAT_REMOVE = 2,
+        LAT_UPDATE = 3,                     // YCSB only
+        LAT_SCAN = 4,
+        LAT_RMW = 5,
+        LAT_KINDS = 6
+    };
+
+    // Range reads of up to Ycsb::MAX_SCAN keys by --roles scanners; not
+    // part of the trace format
+    enum { OP_SCAN = Trace::OP_REMOVE + 1 };
+
+    // --ci: warm-up runs end when two in a row are this close, or after MAX_WARMUPS
+    enum { STEADY_PERCENT = 5, MAX_WARMUPS = 5 };
+
     int numThreads;
+    BenchOptions opts;
+    std::string placement;                  // label of the topology sweep point, if any
+    // Per-run throughput of every benchmark() so far, by class name
+    vector<std::pair<std::string, vector<long long>>> samples;
 
 public:
-    BenchmarkLists(int numThreads) {
+    BenchmarkLists(int numThreads, const BenchOptions& opts, const std::string &placement = "") {
         this->numThreads = numThreads;
+        this->opts = opts;
+        this->placement = placement;
     }
 
-    template<typename L, size_t N = 1>
-    std::pair<long long, long long> benchmark(const seconds testLengthSeconds, const int numRuns, const int numElements, DsType dsType, int readPercent, int insertPercent, int deletePercent, const std::string& reclamation) {
-        long long ops[numThreads][numRuns];
-        long long mem[numThreads][numRuns];
+    template<typename L, size_t N = 1, typename K = UserData>
+    std::pair<long long, long long> benchmark(const seconds testLengthSeconds, int numRuns, const int numElements, DsType dsType, int readPercent, int insertPercent, int deletePercent, const std::string& reclamation) {
+        // --ci: warm-up runs until the throughput settles, then at least
+        // numRuns (and 3) measured runs, until the confidence interval is
+        // narrow enough or maxRuns is reached. Per-run state has room for
+        // maxRuns, and numRuns becomes the number of measured runs.
+        const bool rigorous = opts.ciTarget > 0;
+        const int minRuns = rigorous ? std::max(numRuns, 3) : numRuns;
+        const int maxRuns = rigorous ? std::max(minRuns, opts.ciMaxRuns) : numRuns;
+        // On the heap: --ci allows up to 1000 runs of 384 threads
+        vector<vector<long long>> ops(numThreads, vector<long long>(maxRuns, 0));
+        vector<vector<long long>> mem(numThreads, vector<long long>(maxRuns, 0));
+        vector<vector<long long>> hw(numThreads, vector<long long>(maxRuns * PerfCounters::NUM_EVENTS, 0));
+        vector<long long> rss_prefill(maxRuns), rss_end(maxRuns);
+        // Per-thread histograms for the current run, merged per run afterwards
+        const bool timeOps = opts.latencySample > 0;
+        vector<LatencyHistogram> lat(timeOps ? numThreads * LAT_KINDS : 0);
+        vector<LatencyHistogram> runLat(timeOps ? maxRuns * LAT_KINDS : 0);
+        // Operation counts published for the time-series sampler
+        const bool sampling = opts.sampleMs > 0;
+        std::unique_ptr<TimeSeries::Progress[]> progress(new TimeSeries::Progress[sampling ? numThreads : 0]);
+        TimeSeries series;
+        vector<long long> stalls(maxRuns, 0);
+        vector<long long> yields(maxRuns, 0);
+        // Open loop: operations that started behind schedule, per thread and run
+        const bool openLoop = opts.rate > 0;
+        const double tpn = openLoop ? LatencyHistogram::ticksPerNs() : 0;
+        vector<long long> late(numThreads, 0);
+        vector<long long> lateRuns(maxRuns, 0);
+        // Retire-to-free delays of each run (bench_delay)
+        vector<LatencyHistogram> runDelay(RetireDelay::enabled() ? maxRuns * RetireDelay::NUM_KINDS : 0);
+        // Per-thread operations of the run being recorded
+        vector<vector<uint32_t>> recording(numThreads);
+        vector<long long> recordDropped(numThreads, 0);
+        bool recordRun = false;
+        // --roles groups clipped to this thread count, and their throughput
+        const vector<ThreadRole> groups = roleGroups(readPercent, insertPercent);
+        vector<vector<long long>> groupOps(groups.size(), vector<long long>(maxRuns, 0));
+        // --phases: the phase all threads are in, the operations of each
+        // thread per phase in the current run, and per phase and run the
+        // throughput and the unreclaimed nodes at the end and at the peak
+        const int numPhases = opts.phases.size();
+        atomic<int> phase = { 0 };
+        vector<long long> phaseOps(numThreads * numPhases, 0);
+        vector<vector<long long>> phaseRate(numPhases, vector<long long>(maxRuns, 0));
+        vector<vector<long long>> phaseEnd(numPhases, vector<long long>(maxRuns, 0));
+        vector<vector<long long>> phasePeak(numPhases, vector<long long>(maxRuns, 0));
+        // The size at the end of each phase and how long the phase took, the
+        // threads' net inserts that the size comes from, and the measured
+        // time of each run, which until=N phases make variable
+        vector<vector<long long>> phaseSize(numPhases, vector<long long>(maxRuns, 0));
+        vector<vector<long long>> phaseMs(numPhases, vector<long long>(maxRuns, 0));
+        std::unique_ptr<TimeSeries::Progress[]> netInserts(new TimeSeries::Progress[numPhases > 0 ? numThreads : 0]);
+        long long prefillSize = 0;
+        vector<long long> runMs(maxRuns, testLengthSeconds.count() * 1000);
         atomic<bool> quit = { false };
         atomic<bool> startFlag = { false };
         L* list = nullptr;
@@ -143,40 +379,212 @@ public:
         // otherwise, it takes a lot of time for each data point
         const size_t sequential_prefill_threshold = 100000;
 
-        std::unique_ptr<UserData[]> udpool(new UserData[numElements]);
-        std::vector<UserData*> udarray(numElements);
+        std::unique_ptr<K[]> udpool(new K[numElements]);
+        std::vector<K*> udarray(numElements);
 
         for (size_t i = 0; i < numElements; ++i) {
-            udpool[i] = UserData((long long)i);
+            udpool[i] = K((long long)i);
             udarray[i] = &udpool[i];
         }
 
+        KeyDistribution keyDist(opts.keyDist, numElements);
+
         srand((unsigned) time(NULL));
+        // The main thread prefills and tears down with tid 0
+        NodeArena::bind(0);
 
-        auto rw_lambda = [this,&quit,&startFlag,&list,&udarray,&numElements,&dsType,&readPercent,&insertPercent](long long *ops, const int tid) {
+        auto rw_lambda = [this,&quit,&startFlag,&list,&udarray,&numElements,&dsType,&readPercent,&insertPercent,&keyDist,&progress,sampling,&recording,&recordDropped,&recordRun,tpn,&late,&groups,&phase,&phaseOps,&netInserts,numPhases](long long *ops, long long *counters, LatencyHistogram *lat, const int tid) {
             long long numOps = 0;
+            uint64_t t0 = 0;
             uint64_t r = rand();
-            std::mt19937_64 gen_k(r);
+            KeyGenerator gen_k(keyDist, r, tid, numThreads);
             std::mt19937_64 gen_p(r+1);
+            Topology::pin(tid);
+            NodeArena::bind(tid);
+            const unsigned events = (opts.perf ? PerfCounters::ALL_EVENTS : 0) | (opts.dtlb ? PerfCounters::DTLB_EVENTS : 0);
+            std::unique_ptr<PerfCounters> perf(events ? new PerfCounters(events) : nullptr);
+            std::atomic<long long> *published = sampling ? &progress[tid].ops : nullptr;
+            std::atomic<long long> *sized = (numPhases > 0) ? &netInserts[tid].ops : nullptr;
+            long long net = 0;
+            const bool replay = Trace::replaying();
+            Trace::Cursor cursor = replay ? Trace::cursor(tid) : Trace::Cursor(nullptr, nullptr);
+            vector<uint32_t> *rec = recordRun ? &recording[tid] : nullptr;
+            size_t recCap = 0;
+            long long recDropped = 0;
+            if (rec != nullptr) {
+                // A fixed-size buffer, faulted in before the start so that the timed loop only stores
+                recCap = std::max<size_t>(Trace::RECORD_ENTRIES / numThreads, 1);
+                rec->assign(recCap, 0);
+                rec->clear();
+            }
+            std::unique_ptr<Ycsb> ycsb(opts.ycsb ? new Ycsb(Ycsb::workload(opts.ycsb)) : nullptr);
+            static const int ycsbLat[Ycsb::NUM_OPS] = { LAT_SEARCH, LAT_UPDATE, LAT_INSERT, LAT_SCAN, LAT_RMW };
+            std::unique_ptr<OpenLoop> pacer(opts.rate > 0 ? new OpenLoop(opts.rate / numThreads, opts.arrivals, tpn, r + 2) : nullptr);
+            uint64_t due = 0;
+            // The mix of this thread's --roles group, as cumulative bounds
+            int mixRead = readPercent, mixInsert = readPercent + insertPercent, mixRemove = 100;
+            for (size_t g = 0, first = 0; g < groups.size(); first += groups[g++].threads) {
+                if (tid >= (int) first && tid < (int) first + groups[g].threads) {
+                    mixRead = groups[g].mix.read;
+                    mixInsert = mixRead + groups[g].mix.insert;
+                    mixRemove = mixInsert + groups[g].mix.remove;
+                }
+            }
+            // Operations done by the time this thread entered each phase
+            vector<long long> marks(numPhases, 0);
+            int curPhase = 0;
+            if (numPhases > 0) {
+                mixRead = opts.phases[0].mix.read;
+                mixInsert = mixRead + opts.phases[0].mix.insert;
+                mixRemove = mixInsert + opts.phases[0].mix.remove;
+            }
             while (!startFlag.load()) { }
+            if (perf) perf->start();
+            if (pacer) pacer->start();
             while (!quit.load()) {
-                r = gen_k();
-                auto ix = r%numElements;
-                int op = gen_p()%100;
+                // Latency counts from the intended start of an open-loop operation
+                if (pacer && (due = pacer->next(quit)) == 0) break;
+                if (ycsb) {
+                    const int yop = ycsb->pick(gen_p() % 100);
+                    const size_t ix = gen_k.next(yop == Ycsb::INSERT);
+                    const bool timed = (lat != nullptr && numOps % opts.latencySample == 0);
+                    if (timed) t0 = pacer ? due : LatencyHistogram::now();
+                    switch (yop) {
+                    case Ycsb::READ:
+                        list->search(udarray[ix], tid);
+                        break;
+                    case Ycsb::RMW:
+                        list->search(udarray[ix], tid);
+                        // Fall through
+                    case Ycsb::UPDATE:
+                        list->remove(udarray[ix], tid);
+                        list->insert(udarray[ix], tid);
+                        break;
+                    case Ycsb::INSERT:
+                        list->insert(udarray[ix], tid);
+                        break;
+                    case Ycsb::SCAN: {
+                        const size_t end = std::min(ix + 1 + gen_p() % Ycsb::MAX_SCAN, (size_t) numElements);
+                        for (size_t i = ix; i < end; i++) list->search(udarray[i], tid);
+                        break;
+                    }
+                    }
+                    if (timed) lat[ycsbLat[yop]].record(LatencyHistogram::now() - t0);
+                    numOps += 1;
+                    RetireDelay::op(tid);
+                    if (published != nullptr && (numOps & TimeSeries::PUBLISH_MASK) == 0)
+                        published->store(numOps, std::memory_order_relaxed);
+                    continue;
+                }
+                int kind;
+                size_t ix;
+                if (replay) {
+                    const uint32_t e = cursor.next();
+                    kind = Trace::op(e);
+                    ix = Trace::key(e);
+                } else {
+                    if (numPhases > 0 && phase.load(std::memory_order_relaxed) != curPhase) {
+                        while (curPhase < phase.load(std::memory_order_relaxed)) marks[++curPhase] = numOps;
+                        mixRead = opts.phases[curPhase].mix.read;
+                        mixInsert = mixRead + opts.phases[curPhase].mix.insert;
+                        mixRemove = mixInsert + opts.phases[curPhase].mix.remove;
+                    }
+                    int op = gen_p()%100;
+                    kind = (op < mixRead) ? Trace::OP_SEARCH :
+                           (op < mixInsert) ? Trace::OP_INSERT : Trace::OP_REMOVE;
+                    if (op >= mixRemove) kind = OP_SCAN;
+                    ix = gen_k.next(kind == Trace::OP_INSERT);
+                }
+                if (rec != nullptr) {
+                    if (rec->size() < recCap) rec->push_back(Trace::entry(kind, ix));
+                    else recDropped++;
+                }
+                const bool timed = (lat != nullptr && numOps % opts.latencySample == 0);
+                if (timed) t0 = pacer ? due : LatencyHistogram::now();
 
-                if (op < readPercent) {
+                if (kind == Trace::OP_SEARCH) {
                     bool success = list->search(udarray[ix], tid);
-                } else if (op < (readPercent + insertPercent)) {
-                    list->insert(udarray[ix], tid);
+                    if (timed) lat[LAT_SEARCH].record(LatencyHistogram::now() - t0);
+                } else if (kind == Trace::OP_INSERT) {
+                    const bool added = list->insert(udarray[ix], tid);
+                    if (timed) lat[LAT_INSERT].record(LatencyHistogram::now() - t0);
+                    if (added && sized != nullptr) sized->store(++net, std::memory_order_relaxed);
+                } else if (kind == Trace::OP_REMOVE) {
+                    const bool removed = list->remove(udarray[ix], tid);
+                    if (timed) lat[LAT_REMOVE].record(LatencyHistogram::now() - t0);
+                    if (removed && sized != nullptr) sized->store(--net, std::memory_order_relaxed);
                 } else {
-                    list->remove(udarray[ix], tid);
+                    const size_t end = std::min(ix + 1 + gen_p() % Ycsb::MAX_SCAN, (size_t) numElements);
+                    for (size_t i = ix; i < end; i++) list->search(udarray[i], tid);
+                    if (timed) lat[LAT_SCAN].record(LatencyHistogram::now() - t0);
                 }
                 numOps += 1;
+                RetireDelay::op(tid);
+                if (published != nullptr && (numOps & TimeSeries::PUBLISH_MASK) == 0)
+                    published->store(numOps, std::memory_order_relaxed);
+            }
+            for (int ev = 0; ev < PerfCounters::NUM_EVENTS; ev++) {
+                counters[ev] = -1;
+            }
+            if (perf) {
+                perf->stop();
+                for (int ev = 0; ev < PerfCounters::NUM_EVENTS; ev++) {
+                    counters[ev] = perf->read(ev);
+                }
+            }
+            if (pacer) late[tid] = pacer->late();
+            if (rec != nullptr) recordDropped[tid] = recDropped;
+            for (int p = 0; p < numPhases; p++) {
+                const long long end = (p < curPhase) ? marks[p + 1] : numOps;
+                phaseOps[tid * numPhases + p] = (p <= curPhase) ? end - marks[p] : 0;
             }
             *ops = numOps;
+            NodeArena::unbind();
         };
 
-        for (int irun = 0; irun < numRuns; irun++) {
+        // Wakes up every sampleMs during the measured phase; the values are
+        // not synchronized with each other, which is fine for a trend line
+        auto sample_lambda = [this,&quit,&startFlag,&list,&progress,&series]() {
+            const milliseconds period(opts.sampleMs);
+            while (!startFlag.load()) { }
+            const auto start = steady_clock::now();
+            auto next = start + period;
+            while (true) {
+                this_thread::sleep_until(next);
+                if (quit.load()) break;
+                long long totalOps = 0, unreclaimed = 0;
+                for (int tid = 0; tid < numThreads; tid++) {
+                    totalOps += progress[tid].ops.load(std::memory_order_relaxed);
+                    unreclaimed += list->unreclaimed(tid);
+                }
+                series.record(duration_cast<microseconds>(steady_clock::now() - start).count(),
+                              totalOps, unreclaimed, residentBytes());
+                next += period;
+            }
+        };
+
+        // Arms the stalled threads once per period until the run is over
+        auto stall_lambda = [this,&quit,&startFlag]() {
+            const milliseconds period(Stall::period());
+            while (!startFlag.load()) { }
+            auto next = steady_clock::now() + period;
+            while (true) {
+                this_thread::sleep_until(next);
+                if (quit.load()) break;
+                Stall::arm(numThreads);
+                next += period;
+            }
+            Stall::arm(numThreads, false);
+        };
+
+        // Throughput of the measured runs, and of the last warm-up run
+        vector<long long> measured;
+        long long lastWarmup = 0;
+        int warmups = 0;
+        bool steady = !rigorous;
+        for (int irun = 0; irun < maxRuns; irun++) {
+            const bool firstRun = className.empty();
+            const bool warmup = !steady;
             const int prefillThreadCount = std::min((int) sysconf(_SC_NPROCESSORS_ONLN), 384);  // Max # threads to use for prefilling (cap at 384 threads)
             const int maxThreadsNeeded = (numElements > sequential_prefill_threshold) ? std::max(numThreads, prefillThreadCount) : numThreads;
             list = new L(maxThreadsNeeded);
@@ -186,28 +594,57 @@ public:
             std::mt19937_64 gen(1);
 
             size_t half = numElements / 2;
-            keys.reserve(half);
-            for (size_t i = 0; i < half; ++i) {
-                r = gen();
-                keys.push_back(r%numElements);
+            if (opts.keyDist.type == KeyDistribution::DIST_LATEST) {
+                // Exactly the keys below the first fresh one, shuffled so that the tree stays balanced
+                if (opts.prefillRatio >= 0) half = std::min((size_t) (opts.prefillRatio * numElements + 0.5), (size_t) numElements);
+                keys.resize(half);
+                for (size_t i = 0; i < half; ++i) keys[i] = i;
+                for (size_t i = half; i > 1; --i) std::swap(keys[i - 1], keys[gen() % i]);
+            } else if (opts.prefillRatio < 0) {
+                keys.reserve(half);
+                for (size_t i = 0; i < half; ++i) {
+                    r = gen();
+                    keys.push_back(r%numElements);
+                }
+            } else {
+                // Exactly prefillRatio * numElements distinct keys (partial Fisher-Yates)
+                std::vector<long long> perm(numElements);
+                for (size_t i = 0; i < numElements; ++i) perm[i] = i;
+                half = std::min((size_t) (opts.prefillRatio * numElements + 0.5), (size_t) numElements);
+                for (size_t i = 0; i < half; ++i) {
+                    std::swap(perm[i], perm[i + gen() % (numElements - i)]);
+                }
+                perm.resize(half);
+                keys.swap(perm);
             }
 
             // Use sequential prefill for small datasets, parallel for large datasets
-            if (numElements <= sequential_prefill_threshold || prefillThreadCount < 2) {
-                // Sequential prefill with thread 0
+            long long bulkLoadMs = -1;
+            if (opts.bulkLoad) {
+                // Builds the structure from the sorted keys, with the prefill threads for large datasets
+                const auto loadStart = steady_clock::now();
+                std::vector<K*> prefill(keys.size());
+                for (size_t i = 0; i < keys.size(); i++) prefill[i] = udarray[keys[i]];
+                list->bulk_load(std::move(prefill), (numElements > sequential_prefill_threshold) ? prefillThreadCount : 1);
+                bulkLoadMs = duration_cast<milliseconds>(steady_clock::now() - loadStart).count();
+            } else if (numElements <= sequential_prefill_threshold || prefillThreadCount < 2 || !ConcurrentPrefill<L>::value) {
+                // Sequential prefill with thread 0, also for the sets without a lock
                 for (auto& key : keys) {
-                    list->insert(new UserData(key), 0);
+                    list->insert(udarray[key], 0);
                 }
             } else {
                 // Parallel prefill using all threads
-                auto prefill_lambda = [&list, &keys, half, prefillThreadCount](const int tid) {
+                auto prefill_lambda = [&list, &keys, &udarray, half, prefillThreadCount](const int tid) {
+                    Topology::pin(tid);
+                    NodeArena::bind(tid);
                     size_t chunk_size = (half + prefillThreadCount - 1) / prefillThreadCount;
                     size_t start_idx = tid * chunk_size;
                     size_t end_idx = std::min(start_idx + chunk_size, half);
 
                     for (size_t i = start_idx; i < end_idx; ++i) {
-                        list->insert(new UserData(keys[i]), tid);
+                        list->insert(udarray[keys[i]], tid);
                     }
+                    NodeArena::unbind();
                 };
 
                 thread prefillThreads[prefillThreadCount];
@@ -219,31 +656,214 @@ public:
                 }
             }
             
-            if (irun == 0) {
+            if (numPhases > 0) {
+                // The random draws of the default prefill repeat keys
+                vector<bool> seen(numElements, false);
+                prefillSize = 0;
+                for (auto key : keys) {
+                    if (!seen[key]) prefillSize++;
+                    seen[key] = true;
+                }
+                for (int tid = 0; tid < numThreads; tid++) netInserts[tid].ops.store(0);
+            }
+
+            if (firstRun) {
                 cout << "##### " << list->className() << " #####  \n";
                 className = list->className();
+                if (Topology::current_policy() != Topology::PIN_NONE) {
+                    cout << "Thread placement: " << Topology::policy_name() << "   cpu@node = " << Topology::describe(numThreads) << "\n";
+                }
+                if (bulkLoadMs >= 0) {
+                    cout << "Bulk load: " << bulkLoadMs << " ms\n";
+                }
+                if (opts.ycsb) {
+                    const Ycsb::Workload *w = Ycsb::workload(opts.ycsb);
+                    cout << "YCSB workload " << w->name << ":";
+                    for (int op = 0; op < Ycsb::NUM_OPS; op++) {
+                        if (w->percent[op] != 0) cout << " " << Ycsb::name(op) << " " << w->percent[op] << "%";
+                    }
+                    cout << "   value = " << NodeValue::size() << " bytes\n";
+                } else if (NodeValue::size() != 0) {
+                    cout << "Value: " << NodeValue::size() << " bytes in each list node and tree leaf\n";
+                }
+                if (std::is_same<K, StringKey>::value && StringKey::length() != 0) {
+                    cout << "Keys: strings padded to " << StringKey::length() << " bytes\n";
+                }
+                if (Trace::replaying()) {
+                    cout << "Replaying trace: " << Trace::entries() << " operations in " << Trace::threads()
+                         << " streams (the operation mix comes from the trace)\n";
+                }
+                if (numThreads > sysconf(_SC_NPROCESSORS_ONLN)) {
+                    cout << "Oversubscribed: " << numThreads << " threads on " << sysconf(_SC_NPROCESSORS_ONLN) << " CPUs";
+                    if (Stall::yield_enabled()) cout << ", sched_yield() every " << Stall::yield_every() << " stall points";
+                    cout << "\n";
+                }
+                if (openLoop) {
+                    cout << "Open loop: " << (long long) opts.rate << " ops/sec offered, " << OpenLoop::name(opts.arrivals)
+                         << " arrivals, " << (long long) (opts.rate / numThreads) << " per thread; latency from the intended start\n";
+                }
+                if (Stall::enabled()) {
+                    cout << "Stalled threads: " << std::min(Stall::threads(), numThreads) << " of " << numThreads
+                         << ", " << Stall::duration() << " ms every " << Stall::period() << " ms\n";
+                }
+                if (RetireDelay::enabled() && !isNR) {
+                    cout << "Retire-to-free delay: recorded per node (" << sizeof(RetireStamp) << "-byte stamp in every node)\n";
+                }
+                if (opts.keyDist.type != KeyDistribution::DIST_UNIFORM || opts.prefillRatio >= 0) {
+                    cout << "Key distribution: " << KeyDistribution::name(opts.keyDist.type)
+                         << "   prefill = " << keys.size() << " of " << numElements << " keys\n";
+                }
             }
+            keyDist.restart(keys.size());
+            recordRun = (irun == 0 && !warmup && !opts.recordPath.empty());
+            rss_prefill[irun] = residentBytes();
             thread rwThreads[numThreads];
-            for (int tid = 0; tid < numThreads; tid++) rwThreads[tid] = thread(rw_lambda, &ops[tid][irun], tid);
+            for (auto &h : lat) h.reset();
+            RetireDelay::start(numThreads);
+            for (int tid = 0; tid < numThreads; tid++) rwThreads[tid] = thread(rw_lambda, &ops[tid][irun], &hw[tid][irun * PerfCounters::NUM_EVENTS], timeOps ? &lat[tid * LAT_KINDS] : nullptr, tid);
+            thread sampler;
+            if (sampling) {
+                for (int tid = 0; tid < numThreads; tid++) progress[tid].ops.store(0);
+                series.clear();
+                sampler = thread(sample_lambda);
+            }
+            thread staller;
+            if (Stall::enabled()) {
+                Stall::take_count();
+                staller = thread(stall_lambda);
+            }
+            if (Stall::yield_enabled()) {
+                Stall::take_yields();
+                Stall::set_yielding(true);
+            }
             startFlag.store(true);
             
-            this_thread::sleep_for(testLengthSeconds);
+            const auto runStart = steady_clock::now();
+            if (numPhases == 0) this_thread::sleep_for(testLengthSeconds);
+            long long size = prefillSize;
+            for (int p = 0; p < numPhases; p++) {
+                // Polls the unreclaimed nodes every 10 ms for the peak, and the
+                // size every millisecond when it ends the phase
+                const Phase &ph = opts.phases[p];
+                const bool growing = (ph.until >= size);
+                const auto begin = steady_clock::now();
+                const auto end = begin + seconds(ph.seconds);
+                const milliseconds poll(ph.until >= 0 ? 1 : 10);
+                phase.store(p);
+                long long unreclaimed = 0, peak = 0;
+                for (int polls = 0; ; polls++) {
+                    size = prefillSize;
+                    for (int tid = 0; tid < numThreads; tid++) size += netInserts[tid].ops.load(std::memory_order_relaxed);
+                    if (ph.until < 0 || polls % 10 == 0) {
+                        unreclaimed = 0;
+                        for (int tid = 0; tid < numThreads; tid++) unreclaimed += list->unreclaimed(tid);
+                        peak = std::max(peak, unreclaimed);
+                    }
+                    const auto now = steady_clock::now();
+                    if (now >= end || (ph.until >= 0 && (growing ? size >= ph.until : size <= ph.until))) break;
+                    this_thread::sleep_for(std::min<steady_clock::duration>(poll, end - now));
+                }
+                phaseEnd[p][irun] = unreclaimed;
+                phasePeak[p][irun] = peak;
+                phaseSize[p][irun] = size;
+                phaseMs[p][irun] = std::max<long long>(duration_cast<milliseconds>(steady_clock::now() - begin).count(), 1);
+            }
+            if (numPhases > 0) runMs[irun] = std::max<long long>(duration_cast<milliseconds>(steady_clock::now() - runStart).count(), 1);
             quit.store(true);
+            Stall::set_yielding(false);
             for (int tid = 0; tid < numThreads; tid++) rwThreads[tid].join();
+            yields[irun] = Stall::take_yields();
+            for (int tid = 0; tid < numThreads && openLoop; tid++) lateRuns[irun] += late[tid];
+            for (int p = 0; p < numPhases; p++) {
+                for (int tid = 0; tid < numThreads; tid++) phaseRate[p][irun] += phaseOps[tid * numPhases + p];
+                phaseRate[p][irun] = phaseRate[p][irun] * 1000 / phaseMs[p][irun];
+            }
+            phase.store(0);
+            if (recordRun) {
+                // Threads that did not get to run leave no stream
+                vector<vector<uint32_t>> streams;
+                long long dropped = 0;
+                for (auto &stream : recording) {
+                    if (!stream.empty()) streams.push_back(std::move(stream));
+                }
+                for (int tid = 0; tid < numThreads; tid++) dropped += recordDropped[tid];
+                if (streams.empty() || !Trace::write(opts.recordPath, numElements, streams)) {
+                    cerr << "Cannot write the trace to " << opts.recordPath << "\n";
+                } else {
+                    cout << "Recorded trace: " << opts.recordPath << " (" << streams.size() << " streams)\n";
+                    if (dropped > 0) {
+                        cout << "Recorded trace: dropped " << dropped << " operations past the " << std::max<size_t>(Trace::RECORD_ENTRIES / numThreads, 1)
+                             << " entries kept per thread\n";
+                    }
+                }
+                recordRun = false;
+            }
+            if (Stall::enabled()) {
+                // Disarms the stalled threads before tid 0 tears down
+                staller.join();
+                stalls[irun] = Stall::take_count();
+            }
+            if (sampling) {
+                sampler.join();
+                if (!warmup && !series.append(opts.samplePath, className, numThreads, irun + 1))
+                    cerr << "Cannot write the time series to " << opts.samplePath << "\n";
+            }
             quit.store(false);
             startFlag.store(false);
             for (int tid = 0; tid < numThreads; tid++) mem[tid][irun] = list->calculate_space(tid);
+            rss_end[irun] = residentBytes();
+            for (int tid = 0; tid < numThreads && timeOps; tid++) {
+                for (int k = 0; k < LAT_KINDS; k++) runLat[irun * LAT_KINDS + k].merge(lat[tid * LAT_KINDS + k]);
+            }
+            if (!runDelay.empty()) RetireDelay::take(&runDelay[irun * RetireDelay::NUM_KINDS]);
 
-            if (!isNR) {
-                // For large key ranges, we are running separately for
-                // each individual data point anyway
-                if (numElements <= sequential_prefill_threshold){
-                    for (int i = 0; i < numElements; i++) {
-                        list->remove(udarray[i], 0);
-                    }
-                }
+            // Frees the nodes in parallel; NodeArena::reset() below drops
+            // arena nodes all at once, so with the arena, only nodes too
+            // large for it (with --value) are freed one by one
+            if (NodeArena::current_mode() == NodeArena::ARENA_OFF) {
+                list->destroy(prefillThreadCount);
+            } else if (NodeArena::spilled()) {
+                NodeArena::discard();
+                list->destroy(prefillThreadCount);
             }
             delete list;
+            if (firstRun && NodeArena::current_mode() != NodeArena::ARENA_OFF) {
+                cout << "Node arena: " << NodeArena::regions() << " regions of 2MB, "
+                     << NodeArena::hugetlb_regions() << " via MAP_HUGETLB, the rest via THP\n";
+            }
+            NodeArena::reset();
+
+            if (!rigorous) continue;
+            long long runOps = 0;
+            for (int tid = 0; tid < numThreads; tid++) runOps += ops[tid][irun];
+            runOps = runOps * 1000 / runMs[irun];
+            if (warmup) {
+                // Steady once two warm-up runs in a row agree; the run's slot is reused
+                cout << "Warm-up run " << ++warmups << ": Ops/sec = " << runOps << "\n";
+                steady = (lastWarmup > 0 && std::abs(runOps - lastWarmup) <= lastWarmup * STEADY_PERCENT / 100) || warmups == MAX_WARMUPS;
+                lastWarmup = runOps;
+                lateRuns[irun] = 0;
+                for (int p = 0; p < numPhases; p++) phaseRate[p][irun] = 0;
+                for (int k = 0; k < LAT_KINDS && timeOps; k++) runLat[irun * LAT_KINDS + k].reset();
+                for (int k = 0; k < RetireDelay::NUM_KINDS && !runDelay.empty(); k++) runDelay[irun * RetireDelay::NUM_KINDS + k].reset();
+                irun--;
+                continue;
+            }
+            measured.push_back(runOps);
+            if ((int) measured.size() >= minRuns && Stats::ci95(measured) <= opts.ciTarget / 100 * Stats::mean(measured)) break;
+        }
+        if (rigorous) {
+            numRuns = measured.size();
+            rss_prefill.resize(numRuns);
+            rss_end.resize(numRuns);
+            for (auto &g : groupOps) g.resize(numRuns);
+            for (int p = 0; p < numPhases; p++) {
+                phaseRate[p].resize(numRuns);
+                phaseEnd[p].resize(numRuns);
+                phasePeak[p].resize(numRuns);
+                phaseSize[p].resize(numRuns);
+                phaseMs[p].resize(numRuns);
+            }
         }
 
         vector<long long> agg(numRuns);
@@ -252,7 +872,23 @@ public:
             for (int tid = 0; tid < numThreads; tid++) {
                 agg[irun] += ops[tid][irun];
             }
-            agg[irun] /= testLengthSeconds.count();
+            agg[irun] = agg[irun] * 1000 / runMs[irun];
+        }
+
+        // Throughput of each --roles group
+        for (size_t g = 0, first = 0; g < groups.size(); first += groups[g++].threads) {
+            for (int irun = 0; irun < numRuns; irun++) {
+                for (int tid = first; tid < (int) first + groups[g].threads; tid++) groupOps[g][irun] += ops[tid][irun];
+                groupOps[g][irun] = groupOps[g][irun] * 1000 / runMs[irun];
+            }
+        }
+
+        // Share of open-loop operations that started behind schedule
+        vector<double> latePct(numRuns, 0);
+        vector<long long> achieved(agg);
+        for (int irun = 0; irun < numRuns && openLoop; irun++) {
+            const long long total = agg[irun] * runMs[irun] / 1000;
+            latePct[irun] = (total == 0) ? 0 : 100. * lateRuns[irun] / total;
         }
         
         vector<long long> mem_agg(numRuns);
@@ -264,7 +900,28 @@ public:
             mem_agg[irun] = agg;
         }
 
-        // Compute the median, max and min. numRuns must be an odd number
+        // Hardware events per operation for each run (indexed by
+        // PerfCounters::Event), -1 if the event is unavailable on any thread
+        const int NUM_HW = PerfCounters::NUM_EVENTS;
+        vector<vector<double>> hw_per_op(NUM_HW, vector<double>(numRuns, -1.0));
+        for (int irun = 0; irun < numRuns; irun++) {
+            long long totalOps = 0;
+            for (int tid = 0; tid < numThreads; tid++) totalOps += ops[tid][irun];
+            for (int ev = 0; ev < NUM_HW; ev++) {
+                long long total = 0;
+                for (int tid = 0; tid < numThreads && total >= 0; tid++) {
+                    const long long count = hw[tid][irun * PerfCounters::NUM_EVENTS + ev];
+                    total = (count < 0) ? -1 : total + count;
+                }
+                if (total < 0) continue;
+                hw_per_op[ev][irun] = (totalOps == 0) ? 0 : (double) total / totalOps;
+            }
+        }
+
+        samples.push_back({className, agg});
+
+        // Compute the median, max and min. numRuns must be an odd number,
+        // except with --ci, where this is the upper of the two middle runs
         std::sort(agg.begin(), agg.end());
         auto maxops = agg[numRuns - 1];
         auto minops = agg[0];
@@ -279,36 +936,263 @@ public:
         
         for (int irun = 0; irun < numRuns; irun++) {
             std::cout << "\n\n#### RUN " << (irun + 1) << " RESULT: ####" << "\n";
-            std::cout << "\n----- Benchmark=" << className <<   "   numElements=" << numElements << "   numThreads=" << numThreads << "   testLength=" << testLengthSeconds.count() << "s -----\n";
+            std::cout << "\n----- Benchmark=" << className <<   "   numElements=" << numElements << "   numThreads=" << numThreads << placementTag() << "   testLength=" << testLengthSeconds.count() << "s -----\n";
 
             std::cout << "Ops/sec = " << agg[irun] << "\n";
+            for (size_t g = 0; g < groups.size(); g++) printGroup(groups, g, groupOps[g][irun]);
+            for (int p = 0; p < numPhases; p++) printPhase(p, phaseRate[p][irun], phaseEnd[p][irun], phasePeak[p][irun], phaseSize[p][irun], phaseMs[p][irun]);
             std::cout << "memory_usage (Bytes) = " << mem_agg[irun] << "\n";
+            std::cout << "rss (Bytes) = " << rss_end[irun] << "   after_prefill = " << rss_prefill[irun] << "\n";
+            if (Stall::enabled()) std::cout << "stalls = " << stalls[irun] << "\n";
+            if (Stall::yield_enabled()) std::cout << "yields = " << yields[irun] << "\n";
+            if (openLoop) printOpenLoop(achieved[irun], latePct[irun]);
+            if (opts.dtlb) printTlb(hw_per_op[PerfCounters::DTLB_LOAD_MISSES][irun], hw_per_op[PerfCounters::DTLB_LOADS][irun]);
+            if (opts.perf) {
+                double perOp[NUM_HW];
+                for (int ev = 0; ev < NUM_HW; ev++) perOp[ev] = hw_per_op[ev][irun];
+                printPerf(perOp);
+            }
+            if (timeOps) printLatency(&runLat[irun * LAT_KINDS]);
+            if (!runDelay.empty()) printRetireDelay(&runDelay[irun * RetireDelay::NUM_KINDS]);
         }
         
         std::cout << "\n\n###### MEDIAN RESULT FOR ALL " << numRuns << " RUNS: ######" << "\n";
-          std::cout << "\n----- Benchmark=" << className <<   "   numElements=" << numElements << "   numThreads=" << numThreads << "   testLength=" << testLengthSeconds.count() << "s -----\n";
+          std::cout << "\n----- Benchmark=" << className <<   "   numElements=" << numElements << "   numThreads=" << numThreads << placementTag() << "   testLength=" << testLengthSeconds.count() << "s -----\n";
         
         std::cout << "Ops/sec = " << medianops << "   delta = " << delta << "%   min = " << minops << "   max = " << maxops << "\n";
+        if (rigorous) printStats(agg, warmups);
+        for (size_t g = 0; g < groups.size(); g++) {
+            std::sort(groupOps[g].begin(), groupOps[g].end());
+            printGroup(groups, g, groupOps[g][numRuns / 2]);
+        }
+        for (int p = 0; p < numPhases; p++) {
+            std::sort(phaseRate[p].begin(), phaseRate[p].end());
+            std::sort(phaseEnd[p].begin(), phaseEnd[p].end());
+            std::sort(phasePeak[p].begin(), phasePeak[p].end());
+            std::sort(phaseSize[p].begin(), phaseSize[p].end());
+            std::sort(phaseMs[p].begin(), phaseMs[p].end());
+            printPhase(p, phaseRate[p][numRuns / 2], phaseEnd[p][numRuns / 2], phasePeak[p][numRuns / 2], phaseSize[p][numRuns / 2], phaseMs[p][numRuns / 2]);
+        }
         std::cout << "memory_usage = " << mem_medianops << "   delta = " << mem_delta << "%   min = " << mem_minops << "   max = " << mem_maxops << "\n";
+        std::sort(rss_prefill.begin(), rss_prefill.end());
+        std::sort(rss_end.begin(), rss_end.end());
+        std::cout << "rss = " << rss_end[numRuns / 2] << "   after_prefill = " << rss_prefill[numRuns / 2] << "\n";
+        if (openLoop) {
+            std::sort(latePct.begin(), latePct.end());
+            printOpenLoop(medianops, latePct[numRuns / 2]);
+        }
+        if (opts.dtlb || opts.perf) {
+            // Medians of the per-operation counts, taken per event
+            double perOp[NUM_HW];
+            for (int ev = 0; ev < NUM_HW; ev++) {
+                std::sort(hw_per_op[ev].begin(), hw_per_op[ev].end());
+                perOp[ev] = hw_per_op[ev][numRuns / 2];
+            }
+            if (opts.dtlb) printTlb(perOp[PerfCounters::DTLB_LOAD_MISSES], perOp[PerfCounters::DTLB_LOADS]);
+            if (opts.perf) printPerf(perOp);
+        }
+        if (timeOps) {
+            // Percentiles over the operations of all runs
+            LatencyHistogram allLat[LAT_KINDS];
+            for (int irun = 0; irun < numRuns; irun++) {
+                for (int k = 0; k < LAT_KINDS; k++) allLat[k].merge(runLat[irun * LAT_KINDS + k]);
+            }
+            printLatency(allLat);
+        }
+        if (!runDelay.empty()) {
+            LatencyHistogram allDelay[RetireDelay::NUM_KINDS];
+            for (int irun = 0; irun < numRuns; irun++) {
+                for (int k = 0; k < RetireDelay::NUM_KINDS; k++) allDelay[k].merge(runDelay[irun * RetireDelay::NUM_KINDS + k]);
+            }
+            printRetireDelay(allDelay);
+        }
          return {medianops, mem_medianops};
     }
 
+private:
+    std::string placementTag() const {
+        return placement.empty() ? "" : "   placement=" + placement;
+    }
 
-public:
+    /**
+     * The --roles groups that fit in numThreads, in thread order; threads
+     * past the last group form a "rest" group with the command-line mix
+     */
+    vector<ThreadRole> roleGroups(int readPercent, int insertPercent) const {
+        vector<ThreadRole> groups;
+        if (opts.roles.empty()) return groups;
+        int left = numThreads;
+        for (const ThreadRole &role : opts.roles) {
+            if (left == 0) break;
+            groups.push_back(role);
+            groups.back().threads = std::min(role.threads, left);
+            left -= groups.back().threads;
+        }
+        if (left > 0) groups.push_back({left, {readPercent, insertPercent, 100 - readPercent - insertPercent, 0, "rest"}});
+        return groups;
+    }
+
+    static void printGroup(const vector<ThreadRole> &groups, size_t g, long long opsPerSec) {
+        int first = 0;
+        for (size_t i = 0; i < g; i++) first += groups[i].threads;
+        const ThreadRole &role = groups[g];
+        std::cout << "group " << role.mix.name << " (threads " << first << "-" << first + role.threads - 1 << ", "
+                  << mixTag(role.mix) << "): Ops/sec = " << opsPerSec << "   per_thread = " << opsPerSec / role.threads << "\n";
+    }
+
+    void printPhase(int p, long long opsPerSec, long long unreclaimed, long long peak, long long size, long long ms) const {
+        const Phase &phase = opts.phases[p];
+        std::cout << "phase " << p + 1 << " " << phase.mix.name << " (" << mixTag(phase.mix) << ", ";
+        if (phase.until >= 0) std::cout << "until=" << phase.until;
+        else std::cout << phase.seconds << "s";
+        std::cout << "): Ops/sec = " << opsPerSec << "   unreclaimed = " << unreclaimed << "   peak_unreclaimed = " << peak
+                  << "   size = " << size << "   ms = " << ms << "\n";
+        if (phase.until >= 0 && ms >= phase.seconds * 1000LL) {
+            std::cout << "phase " << p + 1 << " reached its " << phase.seconds << "s limit before until=" << phase.until << "\n";
+        }
+    }
+
+    /**
+     * --ci: mean with its 95% confidence interval, quartiles and outliers
+     * of the per-run throughput
+     */
+    void printStats(const vector<long long> &runs, int warmups) const {
+        const Stats::Summary st = Stats::summarize(runs);
+        const double ciPercent = (st.mean == 0) ? 0 : std::round(10000 * st.ci / st.mean) / 100;
+        std::cout << "mean = " << (long long) st.mean << "   ci95 = +-" << (long long) st.ci << " (" << ciPercent << "%)"
+                  << "   sd = " << (long long) st.sd << "   runs = " << st.n << "   warmup_runs = " << warmups << "\n"
+                  << "median = " << (long long) st.median << "   q1 = " << (long long) st.q1 << "   q3 = " << (long long) st.q3
+                  << "   iqr = " << (long long) (st.q3 - st.q1) << "   outliers = " << st.outliers << "\n";
+        if (ciPercent > opts.ciTarget) {
+            std::cout << "ci_target = " << opts.ciTarget << "% not reached in " << st.n << " runs\n";
+        }
+    }
+
+    static std::string mixTag(const OpMix &mix) {
+        return std::to_string(mix.read) + "/" + std::to_string(mix.insert) + "/" +
+               std::to_string(mix.remove) + "/" + std::to_string(mix.scan);
+    }
+
+    /**
+     * Resident set size of the whole process, or -1 if /proc is unavailable
+     */
+    static long long residentBytes() {
+        long long pages = -1, resident = -1;
+        FILE *f = fopen("/proc/self/statm", "r");
+        if (f == nullptr) return -1;
+        if (fscanf(f, "%lld %lld", &pages, &resident) != 2) resident = -1;
+        fclose(f);
+        return (resident < 0) ? -1 : resident * sysconf(_SC_PAGESIZE);
+    }
+
+    static void printLatency(const LatencyHistogram *hist) {
+        static const char *names[LAT_KINDS] = { "search", "insert", "remove", "update", "scan", "rmw" };
+        const double tpn = LatencyHistogram::ticksPerNs();
+        for (int k = 0; k < LAT_KINDS; k++) {
+            if (hist[k].count() == 0) continue;
+            std::cout << "latency_ns " << names[k] << ": p50 = " << (long long) (hist[k].percentile(50) / tpn)
+                      << "   p99 = " << (long long) (hist[k].percentile(99) / tpn)
+                      << "   p99.9 = " << (long long) (hist[k].percentile(99.9) / tpn)
+                      << "   p99.99 = " << (long long) (hist[k].percentile(99.99) / tpn)
+                      << "   max = " << (long long) (hist[k].max() / tpn)
+                      << "   samples = " << hist[k].count() << "\n";
+        }
+    }
+
+    /**
+     * Retire-to-free delay of the freed nodes in nanoseconds, in operations
+     * of the retiring thread and in scans survived (n/a for Hyaline)
+     */
+    static void printRetireDelay(const LatencyHistogram *hist) {
+        static const char *names[RetireDelay::NUM_KINDS] = { "ns", "ops", "scans" };
+        if (hist[RetireDelay::DELAY_NS].count() == 0) return;
+        const double tpn = LatencyHistogram::ticksPerNs();
+        for (int k = 0; k < RetireDelay::NUM_KINDS; k++) {
+            if (k == RetireDelay::DELAY_SCANS && !RetireDelay::scanned()) {
+                std::cout << "retire_delay_scans = n/a (the scheme does not scan a retired list)\n";
+                continue;
+            }
+            const double scale = (k == RetireDelay::DELAY_NS) ? tpn : 1.0;
+            std::cout << "retire_delay_" << names[k] << ": p50 = " << (long long) (hist[k].percentile(50) / scale)
+                      << "   p99 = " << (long long) (hist[k].percentile(99) / scale)
+                      << "   p99.9 = " << (long long) (hist[k].percentile(99.9) / scale)
+                      << "   max = " << (long long) (hist[k].max() / scale)
+                      << "   freed = " << hist[k].count() << "\n";
+        }
+    }
+
+    /**
+     * Achieved versus offered load; a growing share of late operations
+     * means the offered load is past what the data structure sustains
+     */
+    void printOpenLoop(long long opsPerSec, double latePct) const {
+        std::cout << "offered = " << (long long) opts.rate << "   achieved = " << (long long) (100. * opsPerSec / opts.rate)
+                  << "%   late = " << latePct << "%\n";
+    }
 
-    static void allThroughputTests(DsType dsType, int testLengthSeconds, int numElements, int numberOfRuns, int readPercent, int insertPercent, int deletePercent, const std::string& reclamation, int userThreadCount = -1) {
+    static void printTlb(double missesPerOp, double loadsPerOp) {
+        if (missesPerOp < 0 || loadsPerOp < 0) {
+            std::cout << "dTLB_load_misses/op = n/a (perf_event_open is unavailable)\n";
+            return;
+        }
+        double rate = (loadsPerOp == 0) ? 0 : 100. * missesPerOp / loadsPerOp;
+        std::cout << "dTLB_load_misses/op = " << missesPerOp << "   dTLB_miss_rate = " << rate << "%\n";
+    }
+
+    static void printPerf(const double *perOp) {
+        static const int order[] = {
+            PerfCounters::CYCLES, PerfCounters::INSTRUCTIONS, PerfCounters::LLC_MISSES,
+            PerfCounters::DTLB_LOAD_MISSES, PerfCounters::BRANCH_MISSES, PerfCounters::MACHINE_CLEARS
+        };
+        std::cout << "perf/op:";
+        for (int ev : order) {
+            std::cout << "   " << PerfCounters::name(ev) << " = ";
+            if (perOp[ev] < 0) std::cout << "n/a";
+            else std::cout << perOp[ev];
+            if (ev == PerfCounters::INSTRUCTIONS && perOp[ev] >= 0 && perOp[PerfCounters::CYCLES] > 0)
+                std::cout << "   IPC = " << perOp[ev] / perOp[PerfCounters::CYCLES];
+        }
+        std::cout << "\n";
+    }
+
+
+    template<typename K>
+    static void throughputTests(DsType dsType, int testLengthSeconds, int numElements, int numberOfRuns, int readPercent, int insertPercent, int deletePercent, const std::string& reclamation, int userThreadCount, const BenchOptions& opts) {
         vector<int> threadList;
-        if (userThreadCount > 0) {
+        vector<Topology::SweepPoint> sweep;
+        if (!opts.oversub.empty()) {
+            // Multiples of the online CPUs, within what the schemes support
+            const int cpus = (int) sysconf(_SC_NPROCESSORS_ONLN);
+            for (int factor : opts.oversub) {
+                int threads = factor * cpus;
+                if (threads > MAX_BENCH_THREADS) {
+                    cerr << "Warning: --oversub factor " << factor << " needs " << threads << " threads; capped at "
+                         << MAX_BENCH_THREADS << ", i.e., " << (double) MAX_BENCH_THREADS / cpus << "x the " << cpus << " CPUs\n";
+                    threads = MAX_BENCH_THREADS;
+                }
+                if (std::find(threadList.begin(), threadList.end(), threads) != threadList.end()) {
+                    cerr << "Warning: --oversub factor " << factor << " repeats " << threads << " threads; skipped\n";
+                    continue;
+                }
+                threadList.push_back(threads);
+            }
+        } else if (userThreadCount > 0) {
             threadList = { userThreadCount };
         } else {
-            threadList = { 1, 16, 32, 64, 128, 256, 384 };
+            // The topology sweep; each point is pinned its own way unless --pin is given
+            sweep = sweepPoints(opts.sweepMultiples);
+            for (const Topology::SweepPoint &point : sweep) threadList.push_back(point.threads);
         }
-        // threadList = { 1, 4, 8, 12, 16, 24, 32 }; // for a laptop
+        const bool placeSweep = !sweep.empty() && Topology::current_policy() == Topology::PIN_NONE;
         const int numRuns = numberOfRuns;
         const seconds testLength = seconds(testLengthSeconds);
         vector<int> elemsList;
-        long long ops[8][threadList.size()];
-        long long mem[8][threadList.size()];
+        vector<vector<long long>> ops(8, vector<long long>(threadList.size(), 0));
+        vector<vector<long long>> mem(8, vector<long long>(threadList.size(), 0));
+        // Throughput of the lock-based baselines, in the order of baselineNames()
+        vector<vector<long long>> baseOps(opts.baselines ? baselineNames(dsType).size() : 0, vector<long long>(threadList.size(), 0));
+        // Per-run throughput of every data structure at each thread count (--ci)
+        vector<vector<std::pair<std::string, vector<long long>>>> runSamples(threadList.size());
 
         if (dsType == DS_TYPE_LISTWF || dsType == DS_TYPE_LISTLF) {
             const int MHLNONE = 0;
@@ -328,57 +1212,60 @@ public:
 
             for (int ithread = 0; ithread < threadList.size(); ithread++) {
                         auto nThreads = threadList[ithread];
-                        BenchmarkLists bench(nThreads);
+                        if (placeSweep) Topology::configure(sweep[ithread].pin);
+                        BenchmarkLists bench(nThreads, opts, sweep.empty() ? "" : sweep[ithread].label);
                         if(reclamation == "NR"){
-                            auto result1 = bench.benchmark<HarrisMichaelLinkedListNR<UserData, 1>, 1>(testLength, numRuns, numElements, dsType, readPercent, insertPercent, deletePercent, reclamation);
+                            auto result1 = bench.benchmark<HarrisMichaelLinkedListNR<K, 1>, 1, K>(testLength, numRuns, numElements, dsType, readPercent, insertPercent, deletePercent, reclamation);
                             ops[MHLNONE][ithread] = result1.first;
                             mem[MHLNONE][ithread] = result1.second;
-                            auto result2 = bench.benchmark<HarrisLinkedListNR<UserData, 1>, 1>(testLength, numRuns, numElements, dsType, readPercent, insertPercent, deletePercent, reclamation);
+                            auto result2 = bench.benchmark<HarrisLinkedListNR<K, 1>, 1, K>(testLength, numRuns, numElements, dsType, readPercent, insertPercent, deletePercent, reclamation);
                             ops[HLNONE][ithread] = result2.first;
                             mem[HLNONE][ithread] = result2.second;
                         } else if(reclamation == "EBR"){
-                            auto result3 = bench.benchmark<HarrisMichaelLinkedListEBR<UserData, 1>, 1>(testLength, numRuns, numElements, dsType, readPercent, insertPercent, deletePercent, reclamation);
+                            auto result3 = bench.benchmark<HarrisMichaelLinkedListEBR<K, 1>, 1, K>(testLength, numRuns, numElements, dsType, readPercent, insertPercent, deletePercent, reclamation);
                             ops[MHLEBR][ithread] = result3.first;
                             mem[MHLEBR][ithread] = result3.second;
-                            auto result4 = bench.benchmark<HarrisLinkedListEBR<UserData, 1>, 1>(testLength, numRuns, numElements, dsType, readPercent, insertPercent, deletePercent, reclamation);
+                            auto result4 = bench.benchmark<HarrisLinkedListEBR<K, 1>, 1, K>(testLength, numRuns, numElements, dsType, readPercent, insertPercent, deletePercent, reclamation);
                             ops[HLEBR][ithread] = result4.first;
                             mem[HLEBR][ithread] = result4.second;
                         } else if(reclamation == "HP"){
-                            auto result5 = bench.benchmark<HarrisMichaelLinkedListHP<UserData, 1>, 1>(testLength, numRuns, numElements, dsType, readPercent, insertPercent, deletePercent, reclamation);
+                            auto result5 = bench.benchmark<HarrisMichaelLinkedListHP<K, 1>, 1, K>(testLength, numRuns, numElements, dsType, readPercent, insertPercent, deletePercent, reclamation);
                             ops[MHLHP][ithread] = result5.first;
                             mem[MHLHP][ithread] = result5.second;
-                            auto result6 = (dsType == DS_TYPE_LISTLF) ? bench.benchmark<HarrisLinkedListLFHP<UserData, 1>, 1>(testLength, numRuns, numElements, dsType, readPercent, insertPercent, deletePercent, reclamation) : bench.benchmark<HarrisLinkedListWFHP<UserData, 1>, 1>(testLength, numRuns, numElements, dsType, readPercent, insertPercent, deletePercent, reclamation);
+                            auto result6 = (dsType == DS_TYPE_LISTLF) ? bench.benchmark<HarrisLinkedListLFHP<K, 1>, 1, K>(testLength, numRuns, numElements, dsType, readPercent, insertPercent, deletePercent, reclamation) : bench.benchmark<HarrisLinkedListWFHP<K, 1>, 1, K>(testLength, numRuns, numElements, dsType, readPercent, insertPercent, deletePercent, reclamation);
                             ops[HLHP][ithread] = result6.first;
                             mem[HLHP][ithread] = result6.second;
                         } else if(reclamation == "HPO"){
-                            auto result13 = bench.benchmark<HarrisMichaelLinkedListHPO<UserData, 1>, 1>(testLength, numRuns, numElements, dsType, readPercent, insertPercent, deletePercent, reclamation);
+                            auto result13 = bench.benchmark<HarrisMichaelLinkedListHPO<K, 1>, 1, K>(testLength, numRuns, numElements, dsType, readPercent, insertPercent, deletePercent, reclamation);
                             ops[MHLHPO][ithread] = result13.first;
                             mem[MHLHPO][ithread] = result13.second;
-                            auto result14 = (dsType == DS_TYPE_LISTLF) ? bench.benchmark<HarrisLinkedListLFHPO<UserData, 1>, 1>(testLength, numRuns, numElements, dsType, readPercent, insertPercent, deletePercent, reclamation) : bench.benchmark<HarrisLinkedListWFHPO<UserData, 1>, 1>(testLength, numRuns, numElements, dsType, readPercent, insertPercent, deletePercent, reclamation);
+                            auto result14 = (dsType == DS_TYPE_LISTLF) ? bench.benchmark<HarrisLinkedListLFHPO<K, 1>, 1, K>(testLength, numRuns, numElements, dsType, readPercent, insertPercent, deletePercent, reclamation) : bench.benchmark<HarrisLinkedListWFHPO<K, 1>, 1, K>(testLength, numRuns, numElements, dsType, readPercent, insertPercent, deletePercent, reclamation);
                             ops[HLHPO][ithread] = result14.first;
                             mem[HLHPO][ithread] = result14.second;
                         } else if(reclamation == "IBR"){
-                            auto result7 = bench.benchmark<HarrisMichaelLinkedListIBR<UserData, 1>, 1>(testLength, numRuns, numElements, dsType, readPercent, insertPercent, deletePercent, reclamation);
+                            auto result7 = bench.benchmark<HarrisMichaelLinkedListIBR<K, 1>, 1, K>(testLength, numRuns, numElements, dsType, readPercent, insertPercent, deletePercent, reclamation);
                             ops[MHLIBR][ithread] = result7.first;
                             mem[MHLIBR][ithread] = result7.second;
-                            auto result8 = (dsType == DS_TYPE_LISTLF) ? bench.benchmark<HarrisLinkedListLFIBR<UserData, 1>, 1>(testLength, numRuns, numElements, dsType, readPercent, insertPercent, deletePercent, reclamation) : bench.benchmark<HarrisLinkedListWFIBR<UserData, 1>, 1>(testLength, numRuns, numElements, dsType, readPercent, insertPercent, deletePercent, reclamation);
+                            auto result8 = (dsType == DS_TYPE_LISTLF) ? bench.benchmark<HarrisLinkedListLFIBR<K, 1>, 1, K>(testLength, numRuns, numElements, dsType, readPercent, insertPercent, deletePercent, reclamation) : bench.benchmark<HarrisLinkedListWFIBR<K, 1>, 1, K>(testLength, numRuns, numElements, dsType, readPercent, insertPercent, deletePercent, reclamation);
                             ops[HLIBR][ithread] = result8.first;
                             mem[HLIBR][ithread] = result8.second;
                         } else if(reclamation == "HE"){
-                            auto result9 = bench.benchmark<HarrisMichaelLinkedListHE<UserData, 1>, 1>(testLength, numRuns, numElements, dsType, readPercent, insertPercent, deletePercent, reclamation);
+                            auto result9 = bench.benchmark<HarrisMichaelLinkedListHE<K, 1>, 1, K>(testLength, numRuns, numElements, dsType, readPercent, insertPercent, deletePercent, reclamation);
                             ops[MHLHE][ithread] = result9.first;
                             mem[MHLHE][ithread] = result9.second;
-                            auto result10 = (dsType == DS_TYPE_LISTLF) ? bench.benchmark<HarrisLinkedListLFHE<UserData, 1>, 1>(testLength, numRuns, numElements, dsType, readPercent, insertPercent, deletePercent, reclamation) : bench.benchmark<HarrisLinkedListWFHE<UserData, 1>, 1>(testLength, numRuns, numElements, dsType, readPercent, insertPercent, deletePercent, reclamation);
+                            auto result10 = (dsType == DS_TYPE_LISTLF) ? bench.benchmark<HarrisLinkedListLFHE<K, 1>, 1, K>(testLength, numRuns, numElements, dsType, readPercent, insertPercent, deletePercent, reclamation) : bench.benchmark<HarrisLinkedListWFHE<K, 1>, 1, K>(testLength, numRuns, numElements, dsType, readPercent, insertPercent, deletePercent, reclamation);
                             ops[HLHE][ithread] = result10.first;
                             mem[HLHE][ithread] = result10.second;
                         } else if(reclamation == "HYALINE"){
-                            auto result11 = bench.benchmark<HarrisMichaelLinkedListHyaline<UserData, 1>, 1>(testLength, numRuns, numElements, dsType, readPercent, insertPercent, deletePercent, reclamation);
+                            auto result11 = bench.benchmark<HarrisMichaelLinkedListHyaline<K, 1>, 1, K>(testLength, numRuns, numElements, dsType, readPercent, insertPercent, deletePercent, reclamation);
                             ops[MHLHYALINE][ithread] = result11.first;
                             mem[MHLHYALINE][ithread] = result11.second;
-                            auto result12 = (dsType == DS_TYPE_LISTLF) ? bench.benchmark<HarrisLinkedListLFHyaline<UserData, 1>, 1>(testLength, numRuns, numElements, dsType, readPercent, insertPercent, deletePercent, reclamation) : bench.benchmark<HarrisLinkedListWFHyaline<UserData, 1>, 1>(testLength, numRuns, numElements, dsType, readPercent, insertPercent, deletePercent, reclamation);
+                            auto result12 = (dsType == DS_TYPE_LISTLF) ? bench.benchmark<HarrisLinkedListLFHyaline<K, 1>, 1, K>(testLength, numRuns, numElements, dsType, readPercent, insertPercent, deletePercent, reclamation) : bench.benchmark<HarrisLinkedListWFHyaline<K, 1>, 1, K>(testLength, numRuns, numElements, dsType, readPercent, insertPercent, deletePercent, reclamation);
                             ops[HLHYALINE][ithread] = result12.first;
                             mem[HLHYALINE][ithread] = result12.second;
                         }
+                        if (opts.baselines) runBaselines<K>(bench, ithread, baseOps, testLength, numRuns, numElements, dsType, readPercent, insertPercent, deletePercent, reclamation);
+                        runSamples[ithread] = bench.samples;
                     }
         } else {
             const int NTNONE = 0;
@@ -391,82 +1278,96 @@ public:
 
             for (int ithread = 0; ithread < threadList.size(); ithread++) {
                 auto nThreads = threadList[ithread];
-                BenchmarkLists bench(nThreads);
+                if (placeSweep) Topology::configure(sweep[ithread].pin);
+                BenchmarkLists bench(nThreads, opts, sweep.empty() ? "" : sweep[ithread].label);
 
                 if(reclamation == "NR"){
-                    auto result1 = bench.benchmark<NatarajanMittalTreeNR<UserData, 1>, 1>(testLength, numRuns, numElements, dsType, readPercent, insertPercent, deletePercent, reclamation);
+                    auto result1 = bench.benchmark<NatarajanMittalTreeNR<K, 1>, 1, K>(testLength, numRuns, numElements, dsType, readPercent, insertPercent, deletePercent, reclamation);
                     ops[NTNONE][ithread] = result1.first;
                     mem[NTNONE][ithread] = result1.second;
                 } else if(reclamation == "EBR") {
-                    auto result2 = bench.benchmark<NatarajanMittalTreeEBR<UserData, 1>, 1>(testLength, numRuns, numElements, dsType, readPercent, insertPercent, deletePercent, reclamation);
+                    auto result2 = bench.benchmark<NatarajanMittalTreeEBR<K, 1>, 1, K>(testLength, numRuns, numElements, dsType, readPercent, insertPercent, deletePercent, reclamation);
                     ops[NTEBR][ithread] = result2.first;
                     mem[NTEBR][ithread] = result2.second;
                 } else if(reclamation == "HP"){
-                    auto result3 = bench.benchmark<NatarajanMittalTreeHP<UserData, 1>, 1>(testLength, numRuns, numElements, dsType, readPercent, insertPercent, deletePercent, reclamation);
+                    auto result3 = bench.benchmark<NatarajanMittalTreeHP<K, 1>, 1, K>(testLength, numRuns, numElements, dsType, readPercent, insertPercent, deletePercent, reclamation);
                     ops[NTHP][ithread] = result3.first;
                     mem[NTHP][ithread] = result3.second;
                 } else if(reclamation == "HPO"){
-                    auto result7 = bench.benchmark<NatarajanMittalTreeHPO<UserData, 1>, 1>(testLength, numRuns, numElements, dsType, readPercent, insertPercent, deletePercent, reclamation);
+                    auto result7 = bench.benchmark<NatarajanMittalTreeHPO<K, 1>, 1, K>(testLength, numRuns, numElements, dsType, readPercent, insertPercent, deletePercent, reclamation);
                     ops[NTHPO][ithread] = result7.first;
                     mem[NTHPO][ithread] = result7.second;
                 } else if(reclamation == "IBR"){
-                    auto result4 = bench.benchmark<NatarajanMittalTreeIBR<UserData, 1>, 1>(testLength, numRuns, numElements, dsType, readPercent, insertPercent, deletePercent, reclamation);
+                    auto result4 = bench.benchmark<NatarajanMittalTreeIBR<K, 1>, 1, K>(testLength, numRuns, numElements, dsType, readPercent, insertPercent, deletePercent, reclamation);
                     ops[NTIBR][ithread] = result4.first;
                     mem[NTIBR][ithread] = result4.second;
                 } else if(reclamation == "HE"){
-                    auto result5 = bench.benchmark<NatarajanMittalTreeHE<UserData, 1>, 1>(testLength, numRuns, numElements, dsType, readPercent, insertPercent, deletePercent, reclamation);
+                    auto result5 = bench.benchmark<NatarajanMittalTreeHE<K, 1>, 1, K>(testLength, numRuns, numElements, dsType, readPercent, insertPercent, deletePercent, reclamation);
                     ops[NTHE][ithread] = result5.first;
                     mem[NTHE][ithread] = result5.second;
                 } else if(reclamation == "HYALINE"){
-                    auto result6 = bench.benchmark<NatarajanMittalTreeHyaline<UserData, 1>, 1>(testLength, numRuns, numElements, dsType, readPercent, insertPercent, deletePercent, reclamation);
+                    auto result6 = bench.benchmark<NatarajanMittalTreeHyaline<K, 1>, 1, K>(testLength, numRuns, numElements, dsType, readPercent, insertPercent, deletePercent, reclamation);
                     ops[NTHYALINE][ithread] = result6.first;
                     mem[NTHYALINE][ithread] = result6.second;
                 }
+                if (opts.baselines) runBaselines<K>(bench, ithread, baseOps, testLength, numRuns, numElements, dsType, readPercent, insertPercent, deletePercent, reclamation);
+                runSamples[ithread] = bench.samples;
             }
         }
 
         std::cout<<"\n\nFINAL RESULTS (FOR CHARTS):"<<std::endl<<std::endl;
-        std::cout << "\nResults in ops per second for numRuns=" << numRuns << ",  length=" << testLength.count() << "s \n";
+        std::cout << "\nResults in ops per second for numRuns=" << numRuns << ",  length=" << testLength.count() << "s ";
+        if (opts.ciTarget > 0) std::cout << "(runs until the 95% CI is within " << opts.ciTarget << "% of the mean, at most " << opts.ciMaxRuns << ")";
+        std::cout << "\n";
         std::cout << "\nNumber of elements: " << numElements << "\n\n";
+        // Sweep results are keyed by thread count and placement
+        const char *columns = sweep.empty() ? "Threads, " : "Threads, Placement, ";
         int classSize;
         if (dsType == DS_TYPE_LISTWF || dsType == DS_TYPE_LISTLF) {
             classSize = 2;
             if (reclamation == "NR") {
-                cout << "Threads, HarrisMichaelLinkedListNR, HarrisLinkedListNR\n";
+                cout << columns << "HarrisMichaelLinkedListNR, HarrisLinkedListNR";
             } else if(reclamation == "EBR"){
-                cout << "Threads, HarrisMichaelLinkedListEBR, HarrisLinkedListEBR, HarrisMichaelLinkedListEBR_Memory_Usage, HarrisLinkedListEBR_Memory_Usage\n";
+                cout << columns << "HarrisMichaelLinkedListEBR, HarrisLinkedListEBR, HarrisMichaelLinkedListEBR_Memory_Usage, HarrisLinkedListEBR_Memory_Usage";
             } else if(reclamation == "HP"){
-                cout << "Threads, HarrisMichaelLinkedListHP, HarrisLinkedListHP, HarrisMichaelLinkedListHP_Memory_Usage, HarrisLinkedListHP_Memory_Usage\n";
+                cout << columns << "HarrisMichaelLinkedListHP, HarrisLinkedListHP, HarrisMichaelLinkedListHP_Memory_Usage, HarrisLinkedListHP_Memory_Usage";
             } else if(reclamation == "HPO"){
-                cout << "Threads, HarrisMichaelLinkedListHPO, HarrisLinkedListHPO, HarrisMichaelLinkedListHPO_Memory_Usage, HarrisLinkedListHPO_Memory_Usage\n";
+                cout << columns << "HarrisMichaelLinkedListHPO, HarrisLinkedListHPO, HarrisMichaelLinkedListHPO_Memory_Usage, HarrisLinkedListHPO_Memory_Usage";
             } else if(reclamation == "IBR"){
-                cout << "Threads, HarrisMichaelLinkedListIBR, HarrisLinkedListIBR, HarrisMichaelLinkedListIBR_Memory_Usage, HarrisLinkedListIBR_Memory_Usage\n";
+                cout << columns << "HarrisMichaelLinkedListIBR, HarrisLinkedListIBR, HarrisMichaelLinkedListIBR_Memory_Usage, HarrisLinkedListIBR_Memory_Usage";
             } else if(reclamation == "HE"){
-                cout << "Threads, HarrisMichaelLinkedListHE, HarrisLinkedListHE, HarrisMichaelLinkedListHE_Memory_Usage, HarrisLinkedListHE_Memory_Usage\n";
+                cout << columns << "HarrisMichaelLinkedListHE, HarrisLinkedListHE, HarrisMichaelLinkedListHE_Memory_Usage, HarrisLinkedListHE_Memory_Usage";
             } else if(reclamation == "HYALINE"){
-                cout << "Threads, HarrisMichaelLinkedListHYALINE, HarrisLinkedListHYALINE, HarrisMichaelLinkedListHYALINE_Memory_Usage, HarrisLinkedListHYALINE_Memory_Usage\n";
+                cout << columns << "HarrisMichaelLinkedListHYALINE, HarrisLinkedListHYALINE, HarrisMichaelLinkedListHYALINE_Memory_Usage, HarrisLinkedListHYALINE_Memory_Usage";
             }
         } else {
             classSize = 1;
             if(reclamation == "NR"){
-                cout << "Threads, NatarajanMittalTreeNR\n";
+                cout << columns << "NatarajanMittalTreeNR";
             } else if(reclamation == "EBR"){
-                cout << "Threads, NatarajanMittalTreeEBR, NatarajanMittalTreeEBR_Memory_Usage\n";
+                cout << columns << "NatarajanMittalTreeEBR, NatarajanMittalTreeEBR_Memory_Usage";
             } else if(reclamation == "HP"){
-                cout << "Threads, NatarajanMittalTreeHP, NatarajanMittalTreeHP_Memory_Usage\n";
+                cout << columns << "NatarajanMittalTreeHP, NatarajanMittalTreeHP_Memory_Usage";
             } else if(reclamation == "HPO"){
-                cout << "Threads, NatarajanMittalTreeHPO, NatarajanMittalTreeHPO_Memory_Usage\n";
+                cout << columns << "NatarajanMittalTreeHPO, NatarajanMittalTreeHPO_Memory_Usage";
             } else if(reclamation == "IBR"){
-                cout << "Threads, NatarajanMittalTreeIBR, NatarajanMittalTreeIBR_Memory_Usage\n";
+                cout << columns << "NatarajanMittalTreeIBR, NatarajanMittalTreeIBR_Memory_Usage";
             } else if(reclamation == "HE"){
-                cout << "Threads, NatarajanMittalTreeHE, NatarajanMittalTreeHE_Memory_Usage\n";
+                cout << columns << "NatarajanMittalTreeHE, NatarajanMittalTreeHE_Memory_Usage";
             } else if(reclamation == "HYALINE"){
-                cout << "Threads, NatarajanMittalTreeHYALINE, NatarajanMittalTreeHYALINE_Memory_Usage\n";
+                cout << columns << "NatarajanMittalTreeHYALINE, NatarajanMittalTreeHYALINE_Memory_Usage";
             }
         }
+        if (reclamation == "NR" && opts.baselines) {
+            // NR rows carry memory columns as well; name them so that the baselines line up
+            cout << ((classSize == 2) ? ", HarrisMichaelLinkedListNR_Memory_Usage, HarrisLinkedListNR_Memory_Usage" : ", NatarajanMittalTreeNR_Memory_Usage");
+        }
+        for (size_t ib = 0; ib < baseOps.size(); ib++) cout << ", " << baselineNames(dsType)[ib];
+        cout << "\n";
         for (int ithread = 0; ithread < threadList.size(); ithread++) {
             auto nThreads = threadList[ithread];
             cout << nThreads << ", ";
+            if (!sweep.empty()) cout << sweep[ithread].label << ", ";
             for (int il = 0; il < classSize; il++) {
                 cout << ops[il][ithread] << ", ";
             }
@@ -474,8 +1375,92 @@ public:
             for (int il = 0; il < classSize; il++) {
                 cout << mem[il][ithread] << ", ";
             }
+            for (size_t ib = 0; ib < baseOps.size(); ib++) {
+                if (baseOps[ib][ithread] >= 0) cout << baseOps[ib][ithread];
+                cout << ", ";
+            }
             cout << "\n";
         }
+        if (opts.ciTarget > 0) {
+            cout << "\nSignificance (Welch's t-test over the runs; neighbours by mean throughput):\n";
+            for (int ithread = 0; ithread < threadList.size(); ithread++) {
+                printSignificance(threadList[ithread], sweep.empty() ? "" : sweep[ithread].label, runSamples[ithread]);
+            }
+        }
+    }
+
+    /**
+     * Ranks the data structures of one thread count by mean throughput and
+     * tests each against the next one down. A difference with p >= 0.05 is
+     * within the run-to-run noise.
+     */
+    static void printSignificance(int nThreads, const std::string &label, vector<std::pair<std::string, vector<long long>>> runs) {
+        std::sort(runs.begin(), runs.end(), [](const std::pair<std::string, vector<long long>> &a, const std::pair<std::string, vector<long long>> &b) {
+            return Stats::mean(a.second) > Stats::mean(b.second);
+        });
+        for (size_t i = 0; i + 1 < runs.size(); i++) {
+            const double hi = Stats::mean(runs[i].second), lo = Stats::mean(runs[i + 1].second);
+            const Stats::Test test = Stats::welch(runs[i].second, runs[i + 1].second);
+            cout << nThreads << (label.empty() ? "" : " " + label) << ": " << runs[i].first
+                 << ((test.p < 0.05) ? " > " : " ~ ") << runs[i + 1].first
+                 << "   diff = " << ((lo == 0) ? 0 : std::round(1000 * (hi - lo) / lo) / 10) << "%   p = " << test.p
+                 << ((test.p < 0.05) ? "" : "   (not significant)") << "\n";
+        }
+    }
+
+public:
+
+    /**
+     * Topology::sweep() within what the schemes support
+     */
+    static vector<Topology::SweepPoint> sweepPoints(const vector<int> &multiples) {
+        vector<Topology::SweepPoint> points;
+        for (Topology::SweepPoint point : Topology::sweep(multiples)) {
+            if (point.threads > MAX_BENCH_THREADS) point.threads = MAX_BENCH_THREADS;
+            if (!points.empty() && points.back().threads == point.threads) continue;
+            points.push_back(point);
+        }
+        return points;
+    }
+
+    /**
+     * The baselines of --baselines: the sets around std::set for every data
+     * structure, and the lock-based lists for the lists
+     */
+    static vector<const char *> baselineNames(DsType dsType) {
+        if (dsType == DS_TYPE_TREE) return { "MutexSet", "RWLockSet", "SequentialSet" };
+        return { "MutexSet", "RWLockSet", "HandOverHandLinkedList", "LazyLinkedListEBR", "SequentialSet" };
+    }
+
+    /**
+     * Runs the baselines at one thread count. SequentialSet is not thread
+     * safe; it runs only at one thread, and its column is left blank (-1)
+     * at the other thread counts.
+     */
+    template<typename K>
+    static void runBaselines(BenchmarkLists &bench, int ithread, vector<vector<long long>> &baseOps, seconds testLength, int numRuns, int numElements, DsType dsType, int readPercent, int insertPercent, int deletePercent, const std::string& reclamation) {
+        size_t ib = 0;
+        baseOps[ib++][ithread] = bench.benchmark<MutexSet<K, 1>, 1, K>(testLength, numRuns, numElements, dsType, readPercent, insertPercent, deletePercent, reclamation).first;
+        baseOps[ib++][ithread] = bench.benchmark<RWLockSet<K, 1>, 1, K>(testLength, numRuns, numElements, dsType, readPercent, insertPercent, deletePercent, reclamation).first;
+        if (dsType != DS_TYPE_TREE) {
+            baseOps[ib++][ithread] = bench.benchmark<HandOverHandLinkedList<K, 1>, 1, K>(testLength, numRuns, numElements, dsType, readPercent, insertPercent, deletePercent, reclamation).first;
+            baseOps[ib++][ithread] = bench.benchmark<LazyLinkedListEBR<K, 1>, 1, K>(testLength, numRuns, numElements, dsType, readPercent, insertPercent, deletePercent, reclamation).first;
+        }
+        if (bench.numThreads == 1) {
+            baseOps[ib][ithread] = bench.benchmark<SequentialSet<K, 1>, 1, K>(testLength, numRuns, numElements, dsType, readPercent, insertPercent, deletePercent, reclamation).first;
+        } else {
+            baseOps[ib][ithread] = -1;
+        }
+    }
+
+    static void allThroughputTests(DsType dsType, int testLengthSeconds, int numElements, int numberOfRuns, int readPercent, int insertPercent, int deletePercent, const std::string& reclamation, int userThreadCount = -1, const BenchOptions& opts = BenchOptions()) {
+        if (opts.keyType == KEY_STRING) {
+            throughputTests<StringKey>(dsType, testLengthSeconds, numElements, numberOfRuns, readPercent, insertPercent, deletePercent, reclamation, userThreadCount, opts);
+        } else if (opts.keyType == KEY_ID128) {
+            throughputTests<Id128Key>(dsType, testLengthSeconds, numElements, numberOfRuns, readPercent, insertPercent, deletePercent, reclamation, userThreadCount, opts);
+        } else {
+            throughputTests<UserData>(dsType, testLengthSeconds, numElements, numberOfRuns, readPercent, insertPercent, deletePercent, reclamation, userThreadCount, opts);
+        }
     }
 };
 
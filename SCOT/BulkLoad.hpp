@@ -0,0 +1,166 @@
+/*
+ * Copyright (c) 2024-2025, Md Amit Hasan Arovi, Ruslan Nikolaev
+ * All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#ifndef _BULK_LOAD_H_
+#define _BULK_LOAD_H_
+
+#include <algorithm>
+#include <atomic>
+#include <vector>
+#include "KeyPolicy.hpp"
+#include "Teardown.hpp"
+
+/*
+ * Bulk loading of a data structure before a run.
+ *
+ * The data structures' bulk_load() builds an empty structure from a batch
+ * of keys instead of inserting them one by one. Like destroy(), it needs
+ * quiescence, so the nodes are linked with plain stores; the threads that
+ * run afterwards are started after the build, which orders the stores.
+ * The keys are sorted in chunks that are merged pairwise, each chunk and
+ * each merge on its own thread, and duplicates are dropped. A tree is
+ * built perfectly balanced: the threads build the subtrees at a fixed
+ * depth, taking them from a shared counter, and the calling thread joins
+ * them. A list is made in consecutive chunks by the threads and linked
+ * into one by the calling thread.
+ *
+ * Threads run as in Teardown::parallel(), and thread t passes t as the
+ * tid to the node factories, which the schemes' init_object() needs.
+ */
+class BulkLoad {
+public:
+    enum {
+        // Subtrees per thread, as in Teardown
+        SUBTREES_PER_THREAD = Teardown::SUBTREES_PER_THREAD,
+        // Fewer keys than this are loaded by the calling thread
+        PARALLEL_KEYS = 65536
+    };
+
+    /**
+     * Sorts 'keys' by KeyPolicy and removes duplicate keys
+     */
+    template<typename T>
+    static void sortUnique(std::vector<T*> &keys, int numThreads)
+    {
+        auto less = [](const T *a, const T *b) { return KeyPolicy<T>::less(*a, *b); };
+        auto equal = [](const T *a, const T *b) { return KeyPolicy<T>::equal(*a, *b); };
+        if (keys.size() < PARALLEL_KEYS) numThreads = 1;
+        const size_t size = keys.size();
+        const size_t chunk = (size + numThreads - 1) / numThreads;
+        Teardown::parallel(numThreads, [&keys, &less, size, chunk](int t) {
+            const size_t lo = std::min(size, t * chunk), hi = std::min(size, lo + chunk);
+            std::sort(keys.begin() + lo, keys.begin() + hi, less);
+        });
+        for (size_t width = chunk; width != 0 && width < size; width *= 2) {
+            const int merges = (size + 2 * width - 1) / (2 * width);
+            Teardown::parallel(merges, [&keys, &less, size, width](int m) {
+                const size_t lo = m * 2 * width;
+                const size_t mid = std::min(size, lo + width), hi = std::min(size, lo + 2 * width);
+                std::inplace_merge(keys.begin() + lo, keys.begin() + mid, keys.begin() + hi, less);
+            });
+        }
+        keys.erase(std::unique(keys.begin(), keys.end(), equal), keys.end());
+    }
+
+    /**
+     * Builds a balanced external tree over the sorted keys and returns its
+     * root (nullptr without keys). leaf(key, tid) makes a leaf, and
+     * internal(key, left, right, tid) an internal node whose key is the
+     * smallest one of its right subtree.
+     */
+    template<typename T, typename Leaf, typename Internal>
+    static auto buildTree(const std::vector<T*> &keys, Leaf leaf, Internal internal, int numThreads)
+        -> decltype(leaf(keys[0], 0))
+    {
+        using NodePtr = decltype(leaf(keys[0], 0));
+        const size_t size = keys.size();
+        if (size == 0) return nullptr;
+        if (size < PARALLEL_KEYS) numThreads = 1;
+        // Subtree i holds the keys from bound(i) up to bound(i+1)
+        int depth = 0;
+        while ((1UL << depth) < (size_t) numThreads * SUBTREES_PER_THREAD && (size >> (depth + 1)) != 0) depth++;
+        auto bound = [size, depth](size_t i) { return (i * size) >> depth; };
+        std::vector<NodePtr> level(1UL << depth);
+        std::atomic<size_t> nextSubtree { 0 };
+        Teardown::parallel(numThreads, [&keys, &leaf, &internal, &level, &nextSubtree, &bound](int t) {
+            for (size_t i; (i = nextSubtree.fetch_add(1)) < level.size(); ) {
+                level[i] = build(keys, bound(i), bound(i + 1), leaf, internal, t);
+            }
+        });
+        // Joins pairs of subtrees level by level; 'span' subtrees are below each node
+        for (size_t span = 1; level.size() > 1; span *= 2) {
+            for (size_t j = 0; j < level.size() / 2; j++) {
+                level[j] = internal(keys[bound((2 * j + 1) * span)], level[2 * j], level[2 * j + 1], 0);
+            }
+            level.resize(level.size() / 2);
+        }
+        return level[0];
+    }
+
+    /**
+     * Links nodes for the sorted keys after 'head', which has to be the
+     * last node. node(key, tid) makes a node, and link(node, next) sets
+     * its successor.
+     */
+    template<typename N, typename T, typename Make, typename Link>
+    static void buildList(N *head, const std::vector<T*> &keys, Make node, Link link, int numThreads)
+    {
+        const size_t size = keys.size();
+        if (size == 0) return;
+        if (size < PARALLEL_KEYS) numThreads = 1;
+        const size_t chunk = (size + numThreads - 1) / numThreads;
+        std::vector<N*> first(numThreads, nullptr), last(numThreads, nullptr);
+        Teardown::parallel(numThreads, [&keys, &node, &link, &first, &last, size, chunk](int t) {
+            const size_t lo = std::min(size, t * chunk), hi = std::min(size, lo + chunk);
+            N *next = nullptr;
+            for (size_t i = hi; i-- > lo; ) {
+                N *n = node(keys[i], t);
+                if (next == nullptr) last[t] = n; else link(n, next);
+                next = n;
+            }
+            first[t] = next;
+        });
+        for (int t = 0; t < numThreads; t++) {
+            if (first[t] == nullptr) continue;
+            link(head, first[t]);
+            head = last[t];
+        }
+    }
+
+private:
+    template<typename T, typename Leaf, typename Internal>
+    static auto build(const std::vector<T*> &keys, size_t lo, size_t hi, Leaf &leaf, Internal &internal, int tid)
+        -> decltype(leaf(keys[0], 0))
+    {
+        if (hi - lo == 1) return leaf(keys[lo], tid);
+        const size_t mid = lo + (hi - lo) / 2;
+        auto left = build(keys, lo, mid, leaf, internal, tid);
+        auto right = build(keys, mid, hi, leaf, internal, tid);
+        return internal(keys[mid], left, right, tid);
+    }
+};
+
+#endif /* _BULK_LOAD_H_ */
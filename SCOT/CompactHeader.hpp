@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2024-2025, Md Amit Hasan Arovi, Ruslan Nikolaev
+ * All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#ifndef _COMPACT_HEADER_H_
+#define _COMPACT_HEADER_H_
+
+#include <cstdlib>
+#include <iostream>
+
+/*
+ * Compact reclamation header (build with -DSCOT_COMPACT_HEADER).
+ *
+ * By default IBRNode, HENode and EBRNode carry the retire list link and
+ * the retire era inside the node. Neither is needed before the node is
+ * retired, but they cannot share storage with next/left/right or the
+ * key either: every data structure here traverses retired nodes, and a
+ * reader may still follow a retired node's links until the scheme frees
+ * it. In the compact layout, the two fields move to the retiring thread's
+ * RetiredArray instead, so only the birth era (IBR, HE) stays in the node
+ * and EBRNode becomes empty. The retire scan also walks a dense array
+ * rather than chasing pointers through cold nodes.
+ */
+template<typename E>
+struct RetiredArray {
+    static const size_t INIT_CAPACITY = 256;
+
+    E *items;
+    size_t head;
+    size_t len;
+    size_t cap;
+
+    // Per-thread controllers are not constructed, so no ctor/dtor here
+    inline void init()
+    {
+        items = nullptr;
+        head = 0;
+        len = 0;
+        cap = 0;
+    }
+
+    inline void release()
+    {
+        free(items);
+        init();
+    }
+
+    inline size_t size() const { return len - head; }
+
+    inline E &operator[](size_t i) { return items[head + i]; }
+
+    inline void push(const E &item)
+    {
+        if (len == cap) {
+            if (head > 0 && head >= cap / 2) {
+                for (size_t i = head; i < len; i++)
+                    items[i - head] = items[i];
+                len -= head;
+                head = 0;
+            }
+            if (len == cap) {
+                cap = (cap == 0) ? INIT_CAPACITY : cap * 2;
+                items = static_cast<E*>(realloc(items, sizeof(E) * cap));
+                if (items == nullptr) {
+                    std::cerr << "Error: Failed to allocate memory for RetiredArray\n";
+                    exit(1);
+                }
+            }
+        }
+        items[len++] = item;
+    }
+
+    /**
+     * Keeps the first 'n' items, dropping the rest
+     */
+    inline void truncate(size_t n) { len = head + n; }
+
+    /**
+     * Drops the first 'n' items; the rest move down lazily on push()
+     */
+    inline void drop_front(size_t n) { head += n; }
+};
+
+#endif /* _COMPACT_HEADER_H_ */
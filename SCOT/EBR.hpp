@@ -38,17 +38,36 @@
 #include <atomic>
 #include <malloc.h>
 #include <cstdlib>
+#include "NodeArena.hpp"
+#include "CompactHeader.hpp"
+#include "Stall.hpp"
 
-struct EBRNode {
+#ifdef SCOT_COMPACT_HEADER
+struct EBRNode : ArenaNode {
+};
+#else
+struct EBRNode : ArenaNode {
     struct EBRNode *smr_next;
     size_t retired_epoch;
 };
+#endif
 
 class EBR {
 private:
+#ifdef SCOT_COMPACT_HEADER
+    typedef struct ebr_retired {
+        EBRNode *obj;
+        size_t retired_epoch;
+    } ebr_retired_t;
+#endif
+
     typedef struct retired_node_controller {
+#ifdef SCOT_COMPACT_HEADER
+        RetiredArray<ebr_retired_t> retired;
+#else
         EBRNode *head;
         EBRNode *tail;
+#endif
         size_t epoch_counter;
         size_t list_counter;
         std::atomic<size_t> readerVersion;
@@ -72,14 +91,18 @@ private:
 
 public:
     EBR(const int _maxThreads) : maxThreads{_maxThreads} {
-        rnc = static_cast<retired_node_controller_t*>(aligned_alloc(128, sizeof(retired_node_controller_t) * maxThreads));
+        rnc = static_cast<retired_node_controller_t*>(Numa::alloc_per_thread(sizeof(retired_node_controller_t), maxThreads));
         if (rnc == nullptr) {
             std::cerr << "Error: Failed to allocate memory for retired_node_controller_t array\n";
             exit(1);
         }
         for (int i = 0; i < maxThreads; i++) {
+#ifdef SCOT_COMPACT_HEADER
+            rnc[i].retired.init();
+#else
             rnc[i].head = nullptr;
             rnc[i].tail = nullptr;
+#endif
             rnc[i].epoch_counter = 0;
             rnc[i].list_counter = 0;
             rnc[i].readerVersion.store(UNASSIGNED, std::memory_order_relaxed);
@@ -89,18 +112,31 @@ public:
         }
      }
 
-    ~EBR() {
-        for (int tid = 0; tid < maxThreads; tid++) {
-            EBRNode* current_head = rnc[tid].head;
-            while (current_head != nullptr) {
-                EBRNode* smr_next = current_head->smr_next;
-                delete current_head;
-                current_head = smr_next;
-            }
-            rnc[tid].head = nullptr;
-            rnc[tid].tail = nullptr;
+    /**
+     * Frees the nodes retired by 'tid'. Only safe when no thread is in an
+     * operation, e.g., when the data structure is torn down.
+     */
+    inline void clear_retired(const int tid)
+    {
+#ifdef SCOT_COMPACT_HEADER
+        for (size_t i = 0; i < rnc[tid].retired.size(); i++)
+            delete rnc[tid].retired[i].obj;
+        rnc[tid].retired.release();
+#else
+        EBRNode* current_head = rnc[tid].head;
+        while (current_head != nullptr) {
+            EBRNode* smr_next = current_head->smr_next;
+            delete current_head;
+            current_head = smr_next;
         }
-        free(rnc);
+        rnc[tid].head = nullptr;
+        rnc[tid].tail = nullptr;
+#endif
+    }
+
+    ~EBR() {
+        for (int tid = 0; tid < maxThreads; tid++) clear_retired(tid);
+        Numa::free_per_thread(rnc, sizeof(retired_node_controller_t), maxThreads);
     }
 
     int register_thread() {
@@ -126,6 +162,7 @@ public:
     void start_op(const int tid) noexcept {
         const uint64_t rv = updaterVersion.load();
         rnc[tid].readerVersion.store(rv);
+        Stall::point(tid);
     }
 
     void end_op(const int tid) noexcept {
@@ -134,7 +171,11 @@ public:
 
     void retire(EBRNode* node, const int tid)
     {
+        RetireDelay::retired(node, tid);
         rnc[tid].space++;
+#ifdef SCOT_COMPACT_HEADER
+        rnc[tid].retired.push({node, updaterVersion.load()});
+#else
         node->retired_epoch = updaterVersion.load();
         node->smr_next = nullptr;
         if (!rnc[tid].head) {
@@ -143,6 +184,7 @@ public:
             rnc[tid].tail->smr_next = node;
         }
         rnc[tid].tail = node;
+#endif
         rnc[tid].epoch_counter++;
         if (rnc[tid].epoch_counter % (epoch_freq * maxThreads) == 0) {
             updaterVersion.fetch_add(1, std::memory_order_acq_rel);
@@ -155,12 +197,25 @@ public:
 
     void try_empty_list(const int tid)
     {
+        RetireDelay::scan(tid);
         size_t max_safe_epoch = rnc[0].readerVersion;
         for (size_t i = 1; i < maxThreads; i++) {
             size_t epoch = rnc[i].readerVersion;
             if (epoch < max_safe_epoch)
                 max_safe_epoch = epoch;
         }
+#ifdef SCOT_COMPACT_HEADER
+        RetiredArray<ebr_retired_t> &retired = rnc[tid].retired;
+        size_t freed = 0;
+        while (freed < retired.size() && retired[freed].retired_epoch < max_safe_epoch) {
+            rnc[tid].space--;
+            RetireDelay::freed(retired[freed].obj, tid);
+            delete retired[freed].obj;
+            freed++;
+            rnc[tid].list_counter--;
+        }
+        retired.drop_front(freed);
+#else
         EBRNode* current_head = rnc[tid].head;
         while (current_head != nullptr) {
             if (current_head->retired_epoch >= max_safe_epoch) {
@@ -169,12 +224,14 @@ public:
             }
             EBRNode* smr_next = current_head->smr_next;
             rnc[tid].space--;
+            RetireDelay::freed(current_head, tid);
             delete current_head;
             current_head = smr_next;
             rnc[tid].list_counter--;
         }
         rnc[tid].head = nullptr;
         rnc[tid].tail = nullptr;
+#endif
     }
 
     inline void take_snapshot(const int tid)
@@ -183,9 +240,18 @@ public:
         rnc[tid].count++;
     }
 
+    // Bytes retired by 'tid' and not yet freed, averaged over the snapshots;
+    // 'size' is the footprint of a retired node
     inline long long cal_space(size_t size, const int tid)
     {
-        return (long long) (rnc[tid].sum) / ((ssize_t) rnc[tid].count);
+        if (rnc[tid].count == 0) return 0; // no remove() took a snapshot
+        return (long long) ((double) rnc[tid].sum * size / rnc[tid].count);
+    }
+
+    // Nodes retired by 'tid' and not yet freed; may be read by other threads
+    inline long long cur_space(const int tid)
+    {
+        return (long long) __atomic_load_n(&rnc[tid].space, __ATOMIC_RELAXED);
     }
 };
 
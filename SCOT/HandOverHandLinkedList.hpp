@@ -0,0 +1,185 @@
+/*
+ * Copyright (c) 2024-2025, Md Amit Hasan Arovi, Ruslan Nikolaev
+ * All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#ifndef _HAND_OVER_HAND_LINKED_LIST_H_
+#define _HAND_OVER_HAND_LINKED_LIST_H_
+
+#include <mutex>
+#include <string>
+#include <vector>
+#include "BulkLoad.hpp"
+#include "NodeArena.hpp"
+#include "KeyPolicy.hpp"
+#include "Teardown.hpp"
+
+/**
+ * Sorted linked list with hand-over-hand (lock coupling) locking, as a
+ * blocking baseline for the lock-free lists.
+ *
+ * Every node has a mutex, and a traversal holds at most two of them: it
+ * locks the next node before it unlocks the previous one. A thread can
+ * only lock a node while it holds the predecessor's lock, so a removed
+ * node, unlinked with both locks held, can be freed right away.
+ * <p>
+ * This set has three operations:
+ * <ul>
+ * <li>add(x)      - Blocking
+ * <li>remove(x)   - Blocking
+ * <li>contains(x) - Blocking
+ * </ul><p>
+ */
+template<typename T, size_t N = 1>
+class HandOverHandLinkedList {
+
+private:
+    struct Node : ArenaNode, KeyPrefix<T> {
+        T* key;
+        Node* next;
+        std::mutex lock;
+
+        Node(T* key) : KeyPrefix<T>(key), key{key}, next{nullptr} { }
+    };
+
+    // Head sentinel; the list ends with nullptr
+    alignas(128) Node* head;
+
+    const int maxThreads;
+
+public:
+    HandOverHandLinkedList(const int maxThreads) : maxThreads{maxThreads} {
+        head = new Node(nullptr);
+    }
+
+    ~HandOverHandLinkedList() {
+        Node* node = head;
+        while (node != nullptr) {
+            Node* next = node->next;
+            delete node;
+            node = next;
+        }
+    }
+
+    /**
+     * Frees the nodes still in the list with 'numThreads' threads. Only
+     * safe when no operation is in progress; the list can only be deleted
+     * afterwards.
+     */
+    void destroy(const int numThreads)
+    {
+        Teardown::freeList(head, [](Node *node) { return node->next; }, numThreads);
+        head = nullptr;
+    }
+
+    /**
+     * Links the nodes of 'keys', which are sorted and deduplicated with
+     * 'numThreads' threads, after the sentinel. Only for an empty list and
+     * when no operation is in progress.
+     */
+    void bulk_load(std::vector<T*> keys, const int numThreads)
+    {
+        BulkLoad::sortUnique(keys, numThreads);
+        BulkLoad::buildList(head, keys, [](T *key, const int tid) {
+            return new (WITH_VALUE) Node(key);
+        }, [](Node *node, Node *next) {
+            node->next = next;
+        }, numThreads);
+    }
+
+    std::string className() { return "HandOverHandLinkedList"; }
+
+    bool insert(T* key, const int tid)
+    {
+        const SearchKey<T> skey(key);
+        Node *pred, *curr;
+        find(skey, &pred, &curr);
+        bool inserted = false;
+        if (curr == nullptr || !nodeKeyEqual(curr, skey)) {
+            Node* newNode = new (WITH_VALUE) Node(key);
+            newNode->next = curr;
+            pred->next = newNode;
+            inserted = true;
+        }
+        if (curr != nullptr) curr->lock.unlock();
+        pred->lock.unlock();
+        return inserted;
+    }
+
+    bool remove(T* key, const int tid)
+    {
+        const SearchKey<T> skey(key);
+        Node *pred, *curr;
+        find(skey, &pred, &curr);
+        if (curr == nullptr || !nodeKeyEqual(curr, skey)) {
+            if (curr != nullptr) curr->lock.unlock();
+            pred->lock.unlock();
+            return false;
+        }
+        pred->next = curr->next;
+        curr->lock.unlock();
+        pred->lock.unlock();
+        delete curr;
+        return true;
+    }
+
+    bool search(T* key, const int tid)
+    {
+        const SearchKey<T> skey(key);
+        Node *pred, *curr;
+        find(skey, &pred, &curr);
+        bool isContains = (curr != nullptr && nodeKeyEqual(curr, skey));
+        if (isContains) readNodeValue(curr);
+        if (curr != nullptr) curr->lock.unlock();
+        pred->lock.unlock();
+        return isContains;
+    }
+
+    long long calculate_space(const int tid) { return 0; }
+
+    long long unreclaimed(const int tid) { return 0; }
+
+private:
+    /**
+     * Returns with 'pred' locked and 'curr', the first node whose key is
+     * not smaller than 'key', locked unless it is nullptr
+     */
+    void find(const SearchKey<T> &key, Node **par_pred, Node **par_curr)
+    {
+        Node* pred = head;
+        pred->lock.lock();
+        Node* curr = pred->next;
+        if (curr != nullptr) curr->lock.lock();
+        while (curr != nullptr && nodeKeyLess(curr, key)) {
+            pred->lock.unlock();
+            pred = curr;
+            curr = curr->next;
+            if (curr != nullptr) curr->lock.lock();
+        }
+        *par_pred = pred;
+        *par_curr = curr;
+    }
+};
+
+#endif /* _HAND_OVER_HAND_LINKED_LIST_H_ */
@@ -33,17 +33,21 @@
 #include <set>
 #include <iostream>
 #include <string>
+#include <vector>
+#include "BulkLoad.hpp"
 #include "EBR.hpp"
+#include "KeyPolicy.hpp"
+#include "Teardown.hpp"
 
 template<typename T, size_t N = 1> 
 class HarrisLinkedListEBR {
 
 private:
-    struct Node : EBRNode {
+    struct Node : EBRNode, KeyPrefix<T> {
         T* key;
         std::atomic<Node*> next;
 
-        Node(T* key) : key{key}, next{nullptr} {}
+        Node(T* key) : KeyPrefix<T>(key), key{key}, next{nullptr} {}
     };
 
     alignas(128) std::atomic<Node*> head;
@@ -71,15 +75,43 @@ public:
 
     ~HarrisLinkedListEBR() { }
 
+    /**
+     * Frees the nodes still in the list and the nodes retired to EBR,
+     * with 'numThreads' threads. Only safe when no operation is in
+     * progress; the list can only be deleted afterwards.
+     */
+    void destroy(const int numThreads)
+    {
+        Teardown::freeList(head.load(), [](Node *node) { return unmarkPtr(node->next.load()); }, numThreads);
+        head.store(nullptr);
+        Teardown::freeRetired(ebr, maxThreads, numThreads);
+    }
+
+    /**
+     * Links the nodes of 'keys', which are sorted and deduplicated with
+     * 'numThreads' threads, after the sentinel. Only for an empty list and
+     * when no operation is in progress.
+     */
+    void bulk_load(std::vector<T*> keys, const int numThreads)
+    {
+        BulkLoad::sortUnique(keys, numThreads);
+        BulkLoad::buildList(head.load(), keys, [](T *key, const int tid) {
+            return new (WITH_VALUE) Node(key);
+        }, [](Node *node, Node *next) {
+            node->next.store(next, std::memory_order_relaxed);
+        }, numThreads);
+    }
+
     std::string className() { return "HarrisLinkedListEBR"; }
 
     bool insert(T *key, const int tid)
     {
+        const SearchKey<T> skey(key);
         std::atomic<Node*> *prev;
-        Node *curr, *next, *node = new Node(key);
+        Node *curr, *next, *node = new (WITH_VALUE) Node(key);
         ebr.start_op(tid);
         while (true) {
-            if (find(key, &prev, &curr, &next, tid)) {
+            if (find(skey, &prev, &curr, &next, tid)) {
                 delete node;
                 ebr.end_op(tid);
                 return false;
@@ -95,12 +127,13 @@ public:
 
     bool remove(T *key, const int tid)
     {
+        const SearchKey<T> skey(key);
         std::atomic<Node*> *prev;
         Node *curr, *next;
         ebr.start_op(tid);
         ebr.take_snapshot(tid);
         while (true) {
-            if (!find(key, &prev, &curr, &next, tid)) {
+            if (!find(skey, &prev, &curr, &next, tid)) {
                 ebr.end_op(tid);
                 return false;
             }
@@ -120,6 +153,7 @@ public:
 
     bool search(T *key, const int tid)
     {
+        const SearchKey<T> skey(key);
         std::atomic<Node*> *prev;
         Node *curr, *next;
         ebr.start_op(tid);
@@ -131,23 +165,29 @@ public:
             if (curr == nullptr) break;
             next = curr->next.load();
             if (!checkPtrMarked(next)) {
-                if (curr->key != nullptr && !(*curr->key < *key)) break;
+                if (curr->key != nullptr && !(nodeKeyLess(curr, skey))) break;
                 prev = &curr->next;
             }
             curr = unmarkPtr(next);
         }
-        bool ret = (curr && curr->key != nullptr && *curr->key == *key); 
+        bool ret = (curr && curr->key != nullptr && nodeKeyEqual(curr, skey)); 
+        if (ret) readNodeValue(curr);
         ebr.end_op(tid);
         return ret;
     }
 
     long long calculate_space(const int tid)
     {
-        return ebr.cal_space(sizeof(Node), tid);
+        return ebr.cal_space(sizeof(Node) + NodeValue::size(), tid);
+    }
+
+    long long unreclaimed(const int tid)
+    {
+        return ebr.cur_space(tid);
     }
 
 private:
-    bool find(T *key, std::atomic<Node*> **pprev, Node **pcurr, Node **pnext, const int tid)
+    bool find(const SearchKey<T> &key, std::atomic<Node*> **pprev, Node **pcurr, Node **pnext, const int tid)
     {
         std::atomic<Node*> *prev;
         Node *curr, *next, *prev_next;
@@ -162,7 +202,7 @@ again:
             if (curr == nullptr) break;
             next = curr->next.load();
             if (!checkPtrMarked(next)) {
-                if (curr->key != nullptr && !(*curr->key < *key)) break;
+                if (curr->key != nullptr && !(nodeKeyLess(curr, key))) break;
                 prev = &curr->next;
                 prev_next = next;
             }
@@ -183,7 +223,7 @@ again:
         *pcurr = curr;
         *pprev = prev;
         *pnext = next;
-        return (curr && curr->key != nullptr && *curr->key == *key); 
+        return (curr && curr->key != nullptr && nodeKeyEqual(curr, key)); 
     }
 };
 
@@ -33,18 +33,22 @@
 #include <set>
 #include <iostream>
 #include <string>
+#include <vector>
+#include "BulkLoad.hpp"
 #include "HazardEras.hpp"
+#include "KeyPolicy.hpp"
+#include "Teardown.hpp"
 
 template<typename T, size_t N = 1>
 class HarrisLinkedListLFHE {
 
 private:
 
-    struct Node : HENode {
+    struct Node : HENode, KeyPrefix<T> {
         T* key;
         std::atomic<Node*> next;
 
-        Node(T* key) : key{key}, next{nullptr}  { }
+        Node(T* key) : KeyPrefix<T>(key), key{key}, next{nullptr}  { }
     };
 
 
@@ -80,15 +84,44 @@ public:
 
     ~HarrisLinkedListLFHE() { }
 
+    /**
+     * Frees the nodes still in the list and the nodes retired to Hazard Eras,
+     * with 'numThreads' threads. Only safe when no operation is in
+     * progress; the list can only be deleted afterwards.
+     */
+    void destroy(const int numThreads)
+    {
+        Teardown::freeList(head.load(), [](Node *node) { return unmarkPtr(node->next.load()); }, numThreads);
+        head.store(nullptr);
+        Teardown::freeRetired(he, maxThreads, numThreads);
+    }
+
+    /**
+     * Links the nodes of 'keys', which are sorted and deduplicated with
+     * 'numThreads' threads, after the sentinel. Only for an empty list and
+     * when no operation is in progress.
+     * The nodes get their birth eras from the current era clock.
+     */
+    void bulk_load(std::vector<T*> keys, const int numThreads)
+    {
+        BulkLoad::sortUnique(keys, numThreads);
+        BulkLoad::buildList(head.load(), keys, [this](T *key, const int tid) {
+            return he.init_object(new (WITH_VALUE) Node(key), tid);
+        }, [](Node *node, Node *next) {
+            node->next.store(next, std::memory_order_relaxed);
+        }, numThreads);
+    }
+
     std::string className() { return "HarrisLinkedListHE"; }
 
     bool insert(T* key, const int tid)
     {
+        const SearchKey<T> skey(key);
         Node *curr, *next;
         std::atomic<Node*> *prev;
-        Node *newNode = he.init_object(new Node(key), tid);
+        Node *newNode = he.init_object(new (WITH_VALUE) Node(key), tid);
         while (true) {
-            if (find(key, &prev, &curr, &next, tid)) {
+            if (find(skey, &prev, &curr, &next, tid)) {
                 delete newNode;              // There is already a matching key
                 he.clear(tid);
                 return false;
@@ -104,12 +137,13 @@ public:
 
     bool remove(T* key, const int tid)
     {
+        const SearchKey<T> skey(key);
         Node *curr, *next;
         std::atomic<Node*> *prev;
         he.take_snapshot(tid);
         while (true) {
             /* Try to find the key in the list. */
-            if (!find(key, &prev, &curr, &next, tid)) {
+            if (!find(skey, &prev, &curr, &next, tid)) {
                 he.clear(tid);
                 return false;
             }
@@ -133,6 +167,7 @@ public:
 
     bool search(T *key, const int tid)
     {
+        const SearchKey<T> skey(key);
         std::atomic<Node*> *prev;
         Node *curr, *next;
 
@@ -144,7 +179,7 @@ again:
         while (true)
         {
             do {
-                if (curr->key != nullptr && !(*curr->key < *key)) goto done;
+                if (curr->key != nullptr && !(nodeKeyLess(curr, skey))) goto done;
                 prev = &curr->next;
                 he.protectEraRelease(kHe3, kHe1, tid);
                 curr = unmarkPtr(next);
@@ -174,18 +209,23 @@ again:
         }
 
 done:
-        bool ret = (curr && curr->key != nullptr && *curr->key == *key);
+        bool ret = (curr && curr->key != nullptr && nodeKeyEqual(curr, skey));
+        if (ret) readNodeValue(curr);
         he.clear(tid);
         return ret;
     }
 
     long long calculate_space(const int tid){
-        return he.cal_space(sizeof(Node), tid);
+        return he.cal_space(sizeof(Node) + NodeValue::size(), tid);
+    }
+
+    long long unreclaimed(const int tid){
+        return he.cur_space(tid);
     }
 
 
 private:
-    bool find(T *key, std::atomic<Node*> **pprev, Node **pcurr, Node **pnext, const int tid)
+    bool find(const SearchKey<T> &key, std::atomic<Node*> **pprev, Node **pcurr, Node **pnext, const int tid)
     {
         std::atomic<Node*> *prev;
         Node *curr, *next, *prev_next;
@@ -199,7 +239,7 @@ again:
         while (true)
         {
             do {
-                if (curr->key != nullptr && !(*curr->key < *key)) goto cleanup;
+                if (curr->key != nullptr && !(nodeKeyLess(curr, key))) goto cleanup;
                 prev_next = nullptr;
                 prev = &curr->next;
                 he.protectEraRelease(kHe3, kHe1, tid);
@@ -247,7 +287,7 @@ done:
         *pcurr = curr;
         *pprev = prev;
         *pnext = next;
-        return (curr && curr->key != nullptr && *curr->key == *key);
+        return (curr && curr->key != nullptr && nodeKeyEqual(curr, key));
     }
 };
 
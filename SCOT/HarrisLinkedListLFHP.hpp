@@ -33,17 +33,21 @@
 #include <set>
 #include <iostream>
 #include <string>
+#include <vector>
+#include "BulkLoad.hpp"
 #include "HazardPointers.hpp"
+#include "KeyPolicy.hpp"
+#include "Teardown.hpp"
 
 template<typename T, size_t N = 1>
 class HarrisLinkedListLFHP {
 
 private:
-    struct Node {
+    struct Node : ArenaNode, KeyPrefix<T> {
         T* key;
         std::atomic<Node*> next;
 
-        Node(T* key) : key{key}, next{nullptr} {}
+        Node(T* key) : KeyPrefix<T>(key), key{key}, next{nullptr} {}
     };
 
     alignas(128) std::atomic<Node*> head;
@@ -76,14 +80,42 @@ public:
 
     ~HarrisLinkedListLFHP() { }
 
+    /**
+     * Frees the nodes still in the list and the nodes retired to the hazard pointers,
+     * with 'numThreads' threads. Only safe when no operation is in
+     * progress; the list can only be deleted afterwards.
+     */
+    void destroy(const int numThreads)
+    {
+        Teardown::freeList(head.load(), [](Node *node) { return unmarkPtr(node->next.load()); }, numThreads);
+        head.store(nullptr);
+        Teardown::freeRetired(hp, maxThreads, numThreads);
+    }
+
+    /**
+     * Links the nodes of 'keys', which are sorted and deduplicated with
+     * 'numThreads' threads, after the sentinel. Only for an empty list and
+     * when no operation is in progress.
+     */
+    void bulk_load(std::vector<T*> keys, const int numThreads)
+    {
+        BulkLoad::sortUnique(keys, numThreads);
+        BulkLoad::buildList(head.load(), keys, [](T *key, const int tid) {
+            return new (WITH_VALUE) Node(key);
+        }, [](Node *node, Node *next) {
+            node->next.store(next, std::memory_order_relaxed);
+        }, numThreads);
+    }
+
     std::string className() { return "HarrisLinkedListHP"; }
 
     bool insert(T* key, const int tid)
     {
+        const SearchKey<T> skey(key);
         std::atomic<Node*> *prev;
-        Node *curr, *next, *node = new Node(key);
+        Node *curr, *next, *node = new (WITH_VALUE) Node(key);
         while (true) {
-            if (find(key, &prev, &curr, &next, tid)) {
+            if (find(skey, &prev, &curr, &next, tid)) {
                 delete node;
                 hp.clear(tid);
                 return false;
@@ -99,11 +131,12 @@ public:
 
     bool remove(T *key, const int tid)
     {
+        const SearchKey<T> skey(key);
         std::atomic<Node*> *prev;
         Node *curr, *next;
         hp.take_snapshot(tid);
         while (true) {
-            if (!find(key, &prev, &curr, &next, tid)) {
+            if (!find(skey, &prev, &curr, &next, tid)) {
                 hp.clear(tid);
                 return false;
             }
@@ -123,6 +156,7 @@ public:
 
     bool search(T *key, const int tid)
     {
+        const SearchKey<T> skey(key);
         std::atomic<Node*> *prev;
         Node *curr, *next, *tmp;
 
@@ -134,7 +168,7 @@ again:
         while (true)
         {
             do {
-                if (curr->key != nullptr && !(*curr->key < *key)) goto done;
+                if (curr->key != nullptr && !(nodeKeyLess(curr, skey))) goto done;
                 prev = &curr->next;
                 hp.protectPtrRelease(kHp3, curr, tid);
                 curr = unmarkPtr(next);
@@ -165,18 +199,24 @@ again:
         }
 
 done:
-        bool ret = (curr && curr->key != nullptr && *curr->key == *key);
+        bool ret = (curr && curr->key != nullptr && nodeKeyEqual(curr, skey));
+        if (ret) readNodeValue(curr);
         hp.clear(tid);
         return ret;
     }
 
     long long calculate_space(const int tid)
     {
-        return hp.cal_space(sizeof(Node), tid);
+        return hp.cal_space(sizeof(Node) + NodeValue::size(), tid);
+    }
+
+    long long unreclaimed(const int tid)
+    {
+        return hp.cur_space(tid);
     }
 
 private:
-    bool find(T *key, std::atomic<Node*> **pprev, Node **pcurr, Node **pnext, const int tid)
+    bool find(const SearchKey<T> &key, std::atomic<Node*> **pprev, Node **pcurr, Node **pnext, const int tid)
     {
         std::atomic<Node*> *prev;
         Node *curr, *next, *prev_next, *tmp;
@@ -190,7 +230,7 @@ again:
         while (true)
         {
             do {
-                if (curr->key != nullptr && !(*curr->key < *key)) goto cleanup;
+                if (curr->key != nullptr && !(nodeKeyLess(curr, key))) goto cleanup;
                 prev_next = nullptr;
                 prev = &curr->next;
                 hp.protectPtrRelease(kHp3, curr, tid);
@@ -239,7 +279,7 @@ done:
         *pcurr = curr;
         *pprev = prev;
         *pnext = next;
-        return (curr && curr->key != nullptr && *curr->key == *key);
+        return (curr && curr->key != nullptr && nodeKeyEqual(curr, key));
     }
 };
 
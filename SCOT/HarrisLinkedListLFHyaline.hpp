@@ -33,17 +33,21 @@
 #include <set>
 #include <iostream>
 #include <string>
+#include <vector>
+#include "BulkLoad.hpp"
 #include "Hyaline.hpp"
+#include "KeyPolicy.hpp"
+#include "Teardown.hpp"
 
 template<typename T, size_t N = 1>
 class HarrisLinkedListLFHyaline {
 
 private:
-    struct Node : HyalineNode {
+    struct Node : HyalineNode, KeyPrefix<T> {
         T* key;
         std::atomic<Node*> next;
 
-        Node(T* key) : key{key}, next{nullptr} { }
+        Node(T* key) : KeyPrefix<T>(key), key{key}, next{nullptr} { }
     };
 
 
@@ -72,15 +76,44 @@ public:
 
     ~HarrisLinkedListLFHyaline() { }
 
+    /**
+     * Frees the nodes still in the list with 'numThreads' threads; Hyaline
+     * frees the retired nodes on its own. Only safe when no operation is
+     * in progress; the list can only be deleted afterwards.
+     */
+    void destroy(const int numThreads)
+    {
+        Teardown::freeList(head.load(), [](Node *node) { return unmarkPtr(node->next.load()); }, numThreads);
+        head.store(nullptr);
+    }
+
+    /**
+     * Links the nodes of 'keys', which are sorted and deduplicated with
+     * 'numThreads' threads, after the sentinel. Only for an empty list and
+     * when no operation is in progress.
+     * The builder threads pass their indices to Hyaline as tids, so
+     * 'numThreads' may not exceed maxThreads.
+     */
+    void bulk_load(std::vector<T*> keys, const int numThreads)
+    {
+        BulkLoad::sortUnique(keys, numThreads);
+        BulkLoad::buildList(head.load(), keys, [this](T *key, const int tid) {
+            return hyaline.init_object(new (WITH_VALUE) Node(key), tid);
+        }, [](Node *node, Node *next) {
+            node->next.store(next, std::memory_order_relaxed);
+        }, numThreads);
+    }
+
     std::string className() { return "HarrisLinkedListHYALINE"; }
 
     bool insert(T *key, const int tid)
     {
+        const SearchKey<T> skey(key);
         std::atomic<Node*> *prev;
-        Node *curr, *next, *node = hyaline.init_object(new Node(key), tid);
+        Node *curr, *next, *node = hyaline.init_object(new (WITH_VALUE) Node(key), tid);
         hyaline.start_op(tid);
         while (true) {
-            if (find(key, &prev, &curr, &next, tid)) {
+            if (find(skey, &prev, &curr, &next, tid)) {
                 delete node;
                 hyaline.end_op(tid);
                 return false;
@@ -96,12 +129,13 @@ public:
 
     bool remove(T *key, const int tid)
     {
+        const SearchKey<T> skey(key);
         std::atomic<Node*> *prev;
         Node *curr, *next;
         hyaline.start_op(tid);
         hyaline.take_snapshot(tid);
         while (true) {
-            if (!find(key, &prev, &curr, &next, tid)) {
+            if (!find(skey, &prev, &curr, &next, tid)) {
                 hyaline.end_op(tid);
                 return false;
             }
@@ -121,6 +155,7 @@ public:
 
     bool search(T *key, const int tid)
     {
+        const SearchKey<T> skey(key);
         std::atomic<Node*> *prev;
         Node *curr, *next, *prev_next;
 
@@ -135,7 +170,7 @@ again:
             if (curr == nullptr) break;
             next = hyaline.protect(curr->next, tid);
             if (!checkPtrMarked(next)) {
-                if (curr->key != nullptr && !(*curr->key < *key)) break;
+                if (curr->key != nullptr && !(nodeKeyLess(curr, skey))) break;
                 prev = &curr->next;
                 prev_next = next; // next is unmarked
             } else {
@@ -151,18 +186,24 @@ again:
             }
             curr = unmarkPtr(next);
         }
-        bool ret = (curr && curr->key != nullptr && *curr->key == *key);
+        bool ret = (curr && curr->key != nullptr && nodeKeyEqual(curr, skey));
+        if (ret) readNodeValue(curr);
         hyaline.end_op(tid);
         return ret;
     }
 
     long long calculate_space(const int tid)
     {
-        return hyaline.cal_space(sizeof(Node), tid);
+        return hyaline.cal_space(sizeof(Node) + NodeValue::size(), tid);
+    }
+
+    long long unreclaimed(const int tid)
+    {
+        return hyaline.cur_space(tid);
     }
 
 private:
-    bool find(T *key, std::atomic<Node*> **pprev, Node **pcurr, Node **pnext, const int tid)
+    bool find(const SearchKey<T> &key, std::atomic<Node*> **pprev, Node **pcurr, Node **pnext, const int tid)
     {
         std::atomic<Node*> *prev;
         Node *curr, *next, *prev_next;
@@ -177,7 +218,7 @@ again:
             if (curr == nullptr) break;
             next = hyaline.protect(curr->next, tid);
             if (!checkPtrMarked(next)) {
-                if (curr->key != nullptr && !(*curr->key < *key)) break;
+                if (curr->key != nullptr && !(nodeKeyLess(curr, key))) break;
                 prev = &curr->next;
                 prev_next = next; // next is unmarked
             } else {
@@ -210,7 +251,7 @@ local_recovery:     curr = hyaline.protect(*prev, tid);
         *pcurr = curr;
         *pprev = prev;
         *pnext = next;
-        return (curr && curr->key != nullptr && *curr->key == *key);
+        return (curr && curr->key != nullptr && nodeKeyEqual(curr, key));
     }
 };
 
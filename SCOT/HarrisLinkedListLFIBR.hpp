@@ -33,17 +33,21 @@
 #include <set>
 #include <iostream>
 #include <string>
+#include <vector>
+#include "BulkLoad.hpp"
 #include "IBR.hpp"
+#include "KeyPolicy.hpp"
+#include "Teardown.hpp"
 
 template<typename T, size_t N = 1>
 class HarrisLinkedListLFIBR {
 
 private:
-    struct Node : IBRNode {
+    struct Node : IBRNode, KeyPrefix<T> {
         T* key;
         std::atomic<Node*> next;
 
-        Node(T* key) : key{key}, next{nullptr} { }
+        Node(T* key) : KeyPrefix<T>(key), key{key}, next{nullptr} { }
     };
 
 
@@ -72,15 +76,45 @@ public:
 
     ~HarrisLinkedListLFIBR() { }
 
+    /**
+     * Frees the nodes still in the list and the nodes retired to IBR,
+     * with 'numThreads' threads. Only safe when no operation is in
+     * progress; the list can only be deleted afterwards.
+     */
+    void destroy(const int numThreads)
+    {
+        Teardown::freeList(head.load(), [](Node *node) { return unmarkPtr(node->next.load()); }, numThreads);
+        head.store(nullptr);
+        Teardown::freeRetired(ibr, maxThreads, numThreads);
+    }
+
+    /**
+     * Links the nodes of 'keys', which are sorted and deduplicated with
+     * 'numThreads' threads, after the sentinel. Only for an empty list and
+     * when no operation is in progress.
+     * The builder threads pass their indices to IBR as tids, so
+     * 'numThreads' may not exceed maxThreads.
+     */
+    void bulk_load(std::vector<T*> keys, const int numThreads)
+    {
+        BulkLoad::sortUnique(keys, numThreads);
+        BulkLoad::buildList(head.load(), keys, [this](T *key, const int tid) {
+            return ibr.init_object(new (WITH_VALUE) Node(key), tid);
+        }, [](Node *node, Node *next) {
+            node->next.store(next, std::memory_order_relaxed);
+        }, numThreads);
+    }
+
     std::string className() { return "HarrisLinkedListIBR"; }
 
     bool insert(T *key, const int tid)
     {
+        const SearchKey<T> skey(key);
         std::atomic<Node*> *prev;
-        Node *curr, *next, *node = ibr.init_object(new Node(key), tid);
+        Node *curr, *next, *node = ibr.init_object(new (WITH_VALUE) Node(key), tid);
         ibr.start_op(tid);
         while (true) {
-            if (find(key, &prev, &curr, &next, tid)) {
+            if (find(skey, &prev, &curr, &next, tid)) {
                 delete node;
                 ibr.end_op(tid);
                 return false;
@@ -96,12 +130,13 @@ public:
 
     bool remove(T *key, const int tid)
     {
+        const SearchKey<T> skey(key);
         std::atomic<Node*> *prev;
         Node *curr, *next;
         ibr.start_op(tid);
         ibr.take_snapshot(tid);
         while (true) {
-            if (!find(key, &prev, &curr, &next, tid)) {
+            if (!find(skey, &prev, &curr, &next, tid)) {
                 ibr.end_op(tid);
                 return false;
             }
@@ -121,6 +156,7 @@ public:
 
     bool search(T *key, const int tid)
     {
+        const SearchKey<T> skey(key);
         std::atomic<Node*> *prev;
         Node *curr, *next, *prev_next;
 
@@ -135,7 +171,7 @@ again:
             if (curr == nullptr) break;
             next = ibr.protect(curr->next, tid);
             if (!checkPtrMarked(next)) {
-                if (curr->key != nullptr && !(*curr->key < *key)) break;
+                if (curr->key != nullptr && !(nodeKeyLess(curr, skey))) break;
                 prev = &curr->next;
                 prev_next = next; // next is unmarked
             } else {
@@ -151,18 +187,24 @@ again:
             }
             curr = unmarkPtr(next);
         }
-        bool ret = (curr && curr->key != nullptr && *curr->key == *key);
+        bool ret = (curr && curr->key != nullptr && nodeKeyEqual(curr, skey));
+        if (ret) readNodeValue(curr);
         ibr.end_op(tid);
         return ret;
     }
 
     long long calculate_space(const int tid)
     {
-        return ibr.cal_space(sizeof(Node), tid);
+        return ibr.cal_space(sizeof(Node) + NodeValue::size(), tid);
+    }
+
+    long long unreclaimed(const int tid)
+    {
+        return ibr.cur_space(tid);
     }
 
 private:
-    bool find(T *key, std::atomic<Node*> **pprev, Node **pcurr, Node **pnext, const int tid)
+    bool find(const SearchKey<T> &key, std::atomic<Node*> **pprev, Node **pcurr, Node **pnext, const int tid)
     {
         std::atomic<Node*> *prev;
         Node *curr, *next, *prev_next;
@@ -177,7 +219,7 @@ again:
             if (curr == nullptr) break;
             next = ibr.protect(curr->next, tid);
             if (!checkPtrMarked(next)) {
-                if (curr->key != nullptr && !(*curr->key < *key)) break;
+                if (curr->key != nullptr && !(nodeKeyLess(curr, key))) break;
                 prev = &curr->next;
                 prev_next = next; // next is unmarked
             } else {
@@ -210,7 +252,7 @@ local_recovery:     curr = ibr.protect(*prev, tid);
         *pcurr = curr;
         *pprev = prev;
         *pnext = next;
-        return (curr && curr->key != nullptr && *curr->key == *key);
+        return (curr && curr->key != nullptr && nodeKeyEqual(curr, key));
     }
 };
 
@@ -33,18 +33,22 @@
 #include <set>
 #include <iostream>
 #include <string>
+#include <vector>
+#include "BulkLoad.hpp"
 #include "EBR.hpp"
+#include "KeyPolicy.hpp"
+#include "Teardown.hpp"
 
 template<typename T, size_t N = 1> 
 class HarrisLinkedListNR {
 
 private:
 
-    struct Node {
+    struct Node : ArenaNode, KeyPrefix<T> {
         T* key;
         std::atomic<Node*> next;
         
-        Node(T* key) : key{key}, next{nullptr} {}
+        Node(T* key) : KeyPrefix<T>(key), key{key}, next{nullptr} {}
     };
 
 
@@ -72,14 +76,41 @@ public:
 
     ~HarrisLinkedListNR() { }
 
+    /**
+     * Frees the nodes still in the list with 'numThreads' threads (removed
+     * nodes are never freed without reclamation). Only safe when no
+     * operation is in progress; the list can only be deleted afterwards.
+     */
+    void destroy(const int numThreads)
+    {
+        Teardown::freeList(head.load(), [](Node *node) { return unmarkPtr(node->next.load()); }, numThreads);
+        head.store(nullptr);
+    }
+
+    /**
+     * Links the nodes of 'keys', which are sorted and deduplicated with
+     * 'numThreads' threads, after the sentinel. Only for an empty list and
+     * when no operation is in progress.
+     */
+    void bulk_load(std::vector<T*> keys, const int numThreads)
+    {
+        BulkLoad::sortUnique(keys, numThreads);
+        BulkLoad::buildList(head.load(), keys, [](T *key, const int tid) {
+            return new (WITH_VALUE) Node(key);
+        }, [](Node *node, Node *next) {
+            node->next.store(next, std::memory_order_relaxed);
+        }, numThreads);
+    }
+
     std::string className() { return "HarrisLinkedListNR"; }
 
     bool insert(T *key, const int tid)
     {
+        const SearchKey<T> skey(key);
         std::atomic<Node*> *prev;
-        Node *curr, *next, *node = new Node(key);
+        Node *curr, *next, *node = new (WITH_VALUE) Node(key);
         while (true) {
-            if (find(key, &prev, &curr, &next, tid)) {
+            if (find(skey, &prev, &curr, &next, tid)) {
                 delete node;
                 return false;
             }
@@ -91,10 +122,11 @@ public:
 
     bool remove(T *key, const int tid)
     {
+        const SearchKey<T> skey(key);
         std::atomic<Node*> *prev;
         Node *curr, *next;
         while (true) {
-            if (!find(key, &prev, &curr, &next, tid)) {
+            if (!find(skey, &prev, &curr, &next, tid)) {
                 return false;
             }
             Node *tmp = next;
@@ -108,9 +140,12 @@ public:
 
     bool search(T *key, const int tid)
     {
+        const SearchKey<T> skey(key);
         std::atomic<Node*> *prev;
         Node *curr, *next;
-        return find(key, &prev, &curr, &next, tid);
+        bool ret = find(skey, &prev, &curr, &next, tid);
+        if (ret) readNodeValue(curr);
+        return ret;
     }
 
     long long calculate_space(const int tid)
@@ -118,8 +153,13 @@ public:
         return 0;
     }
 
+    long long unreclaimed(const int tid)
+    {
+        return 0;
+    }
+
 private:
-    bool find(T *key, std::atomic<Node*> **pprev, Node **pcurr, Node **pnext, const int tid)
+    bool find(const SearchKey<T> &key, std::atomic<Node*> **pprev, Node **pcurr, Node **pnext, const int tid)
     {
         std::atomic<Node*> *prev;
         Node *curr, *next, *prev_next;
@@ -134,7 +174,7 @@ again:
             if (curr == nullptr) break;
             next = curr->next.load();
             if (!checkPtrMarked(next)) {
-                if (curr->key != nullptr && !(*curr->key < *key)) break;
+                if (curr->key != nullptr && !(nodeKeyLess(curr, key))) break;
                 prev = &curr->next;
                 prev_next = next;
             }
@@ -150,7 +190,7 @@ again:
         *pcurr = curr;
         *pprev = prev;
         *pnext = next;
-        return (curr && curr->key != nullptr && *curr->key == *key); 
+        return (curr && curr->key != nullptr && nodeKeyEqual(curr, key)); 
     }
 };
 
@@ -33,18 +33,22 @@
 #include <set>
 #include <iostream>
 #include <string>
+#include <vector>
+#include "BulkLoad.hpp"
 #include "Hyaline.hpp"
 #include "WaitFree.hpp"
+#include "KeyPolicy.hpp"
+#include "Teardown.hpp"
 
 template<typename T, size_t N = 1>
 class HarrisLinkedListWFHyaline {
 
 private:
-    struct Node : HyalineNode {
+    struct Node : HyalineNode, KeyPrefix<T> {
         T* key;
         std::atomic<Node*> next;
 
-        Node(T* key) : key{key}, next{nullptr} { }
+        Node(T* key) : KeyPrefix<T>(key), key{key}, next{nullptr} { }
     };
 
 
@@ -74,20 +78,49 @@ public:
 
     ~HarrisLinkedListWFHyaline() { }
 
+    /**
+     * Frees the nodes still in the list with 'numThreads' threads; Hyaline
+     * frees the retired nodes on its own. Only safe when no operation is
+     * in progress; the list can only be deleted afterwards.
+     */
+    void destroy(const int numThreads)
+    {
+        Teardown::freeList(head.load(), [](Node *node) { return unmarkPtr(node->next.load()); }, numThreads);
+        head.store(nullptr);
+    }
+
+    /**
+     * Links the nodes of 'keys', which are sorted and deduplicated with
+     * 'numThreads' threads, after the sentinel. Only for an empty list and
+     * when no operation is in progress.
+     * The builder threads pass their indices to Hyaline as tids, so
+     * 'numThreads' may not exceed maxThreads.
+     */
+    void bulk_load(std::vector<T*> keys, const int numThreads)
+    {
+        BulkLoad::sortUnique(keys, numThreads);
+        BulkLoad::buildList(head.load(), keys, [this](T *key, const int tid) {
+            return hyaline.init_object(new (WITH_VALUE) Node(key), tid);
+        }, [](Node *node, Node *next) {
+            node->next.store(next, std::memory_order_relaxed);
+        }, numThreads);
+    }
+
     std::string className() { return "HarrisLinkedListHYALINE"; }
 
     bool insert(T *key, const int tid)
     {
+        const SearchKey<T> skey(key);
         T* h_key;
         size_t h_tag;
         int h_tid;
         std::atomic<Node*> *prev;
-        Node *curr, *next, *node = hyaline.init_object(new Node(key), tid);
+        Node *curr, *next, *node = hyaline.init_object(new (WITH_VALUE) Node(key), tid);
         bool help = wf.help_threads(&h_key, &h_tag, &h_tid, tid);
         hyaline.start_op(tid);
         if (help) slow_search(h_key, h_tag, h_tid, tid);
         while (true) {
-            if (find(key, &prev, &curr, &next, tid)) {
+            if (find(skey, &prev, &curr, &next, tid)) {
                 delete node;
                 hyaline.end_op(tid);
                 return false;
@@ -103,6 +136,7 @@ public:
 
     bool remove(T *key, const int tid)
     {
+        const SearchKey<T> skey(key);
         T* h_key;
         size_t h_tag;
         int h_tid;
@@ -113,7 +147,7 @@ public:
         if (help) slow_search(h_key, h_tag, h_tid, tid);
         hyaline.take_snapshot(tid);
         while (true) {
-            if (!find(key, &prev, &curr, &next, tid)) {
+            if (!find(skey, &prev, &curr, &next, tid)) {
                 hyaline.end_op(tid);
                 return false;
             }
@@ -133,6 +167,7 @@ public:
 
     bool search(T *key, const int tid)
     {
+        const SearchKey<T> skey(key);
         std::atomic<Node*> *prev;
         Node *curr, *next, *prev_next;
         size_t count = WF_THRESHOLD;
@@ -152,7 +187,7 @@ again:
                 if (curr == nullptr) break;
                 next = hyaline.protect(curr->next, tid);
                 if (!checkPtrMarked(next)) {
-                    if (curr->key != nullptr && !(*curr->key < *key)) break;
+                    if (curr->key != nullptr && !(nodeKeyLess(curr, skey))) break;
                     prev = &curr->next;
                     prev_next = next; // next is unmarked
                 } else {
@@ -168,7 +203,8 @@ again:
                 }
                 curr = unmarkPtr(next);
             }
-            ret = (curr && curr->key != nullptr && *curr->key == *key);
+            ret = (curr && curr->key != nullptr && nodeKeyEqual(curr, skey));
+            if (ret) readNodeValue(curr);
         }
         hyaline.end_op(tid);
         return ret;
@@ -176,6 +212,7 @@ again:
 
     bool slow_search(T *key, size_t tag, const int tid, const int mytid)
     {
+        const SearchKey<T> skey(key);
         std::atomic<Node*> *prev;
         Node *curr, *next, *prev_next;
 
@@ -189,7 +226,7 @@ again:
             if (curr == nullptr) break;
             next = hyaline.protect(curr->next, mytid);
             if (!checkPtrMarked(next)) {
-                if (curr->key != nullptr && !(*curr->key < *key)) break;
+                if (curr->key != nullptr && !(nodeKeyLess(curr, skey))) break;
                 prev = &curr->next;
                 prev_next = next; // next is unmarked
             } else {
@@ -216,18 +253,23 @@ again:
             }
             curr = unmarkPtr(next);
         }
-        bool ret = (curr && curr->key != nullptr && *curr->key == *key);
+        bool ret = (curr && curr->key != nullptr && nodeKeyEqual(curr, skey));
         wf.produce_result(tag, (size_t) ret << 1, tid);
         return ret;
     }
 
     long long calculate_space(const int tid)
     {
-        return hyaline.cal_space(sizeof(Node), tid);
+        return hyaline.cal_space(sizeof(Node) + NodeValue::size(), tid);
+    }
+
+    long long unreclaimed(const int tid)
+    {
+        return hyaline.cur_space(tid);
     }
 
 private:
-    bool find(T *key, std::atomic<Node*> **pprev, Node **pcurr, Node **pnext, const int tid)
+    bool find(const SearchKey<T> &key, std::atomic<Node*> **pprev, Node **pcurr, Node **pnext, const int tid)
     {
         std::atomic<Node*> *prev;
         Node *curr, *next, *prev_next;
@@ -242,7 +284,7 @@ again:
             if (curr == nullptr) break;
             next = hyaline.protect(curr->next, tid);
             if (!checkPtrMarked(next)) {
-                if (curr->key != nullptr && !(*curr->key < *key)) break;
+                if (curr->key != nullptr && !(nodeKeyLess(curr, key))) break;
                 prev = &curr->next;
                 prev_next = next; // next is unmarked
             } else {
@@ -275,7 +317,7 @@ local_recovery:     curr = hyaline.protect(*prev, tid);
         *pcurr = curr;
         *pprev = prev;
         *pnext = next;
-        return (curr && curr->key != nullptr && *curr->key == *key);
+        return (curr && curr->key != nullptr && nodeKeyEqual(curr, key));
     }
 };
 
@@ -35,7 +35,11 @@
 #include <set>
 #include <iostream>
 #include <string>
+#include <vector>
+#include "BulkLoad.hpp"
 #include "HazardEras.hpp"
+#include "KeyPolicy.hpp"
+#include "Teardown.hpp"
 
 
 
@@ -61,11 +65,11 @@ template<typename T, size_t N = 1>
 class HarrisMichaelLinkedListHE {
 
 private:
-    struct Node : HENode {
+    struct Node : HENode, KeyPrefix<T> {
     	T* key;
     	std::atomic<Node*> next;
 
-        Node(T* key) : key{key}, next{nullptr}  {}
+        Node(T* key) : KeyPrefix<T>(key), key{key}, next{nullptr}  {}
     };
 
     alignas(128) std::atomic<Node*> head;
@@ -89,6 +93,34 @@ public:
     // We don't expect the destructor to be called if this instance can still be in use
     ~HarrisMichaelLinkedListHE() { }
 
+    /**
+     * Frees the nodes still in the list and the nodes retired to Hazard Eras,
+     * with 'numThreads' threads. Only safe when no operation is in
+     * progress; the list can only be deleted afterwards.
+     */
+    void destroy(const int numThreads)
+    {
+        Teardown::freeList(head.load(), [this](Node *node) { return getUnmarked(node->next.load()); }, numThreads);
+        head.store(nullptr);
+        Teardown::freeRetired(he, maxThreads, numThreads);
+    }
+
+    /**
+     * Links the nodes of 'keys', which are sorted and deduplicated with
+     * 'numThreads' threads, after the sentinel. Only for an empty list and
+     * when no operation is in progress.
+     * The nodes get their birth eras from the current era clock.
+     */
+    void bulk_load(std::vector<T*> keys, const int numThreads)
+    {
+        BulkLoad::sortUnique(keys, numThreads);
+        BulkLoad::buildList(head.load(), keys, [this](T *key, const int tid) {
+            return he.init_object(new (WITH_VALUE) Node(key), tid);
+        }, [](Node *node, Node *next) {
+            node->next.store(next, std::memory_order_relaxed);
+        }, numThreads);
+    }
+
     std::string className() { return "HarrisMichaelLinkedListHE"; }
 
 
@@ -102,11 +134,12 @@ public:
      */
     bool insert(T* key, const int tid)
     {
+        const SearchKey<T> skey(key);
         Node *curr, *next;
         std::atomic<Node*> *prev;
-        Node* newNode = he.init_object(new Node(key), tid);
+        Node* newNode = he.init_object(new (WITH_VALUE) Node(key), tid);
         while (true) {
-            if (find(key, &prev, &curr, &next, tid)) {
+            if (find(skey, &prev, &curr, &next, tid)) {
                 delete newNode;              // There is already a matching key
                 he.clear(tid);
                 return false;
@@ -128,13 +161,14 @@ public:
      */
     bool remove(T* key, const int tid)
     {
+        const SearchKey<T> skey(key);
     	he.take_snapshot(tid);
         Node *curr, *next;
         std::atomic<Node*> *prev;
         //hp.take_snapshot(tid);
         while (true) {
             /* Try to find the key in the list. */
-            if (!find(key, &prev, &curr, &next, tid)) {
+            if (!find(skey, &prev, &curr, &next, tid)) {
                 he.clear(tid);
                 return false;
             }
@@ -165,15 +199,21 @@ public:
      */
     bool search (T* key, const int tid)
     {
+        const SearchKey<T> skey(key);
         Node *curr, *next;
         std::atomic<Node*> *prev;
-        bool isContains = find(key, &prev, &curr, &next, tid);
+        bool isContains = find(skey, &prev, &curr, &next, tid);
+        if (isContains) readNodeValue(curr);
         he.clear(tid);
         return isContains;
     }
     
     long long calculate_space(const int tid){
-        return he.cal_space(sizeof(Node), tid);
+        return he.cal_space(sizeof(Node) + NodeValue::size(), tid);
+    }
+
+    long long unreclaimed(const int tid){
+        return he.cur_space(tid);
     }
     
 private:
@@ -183,7 +223,7 @@ private:
      * <p>
      * Progress Condition: Lock-Free
      */
-    bool find (T* key, std::atomic<Node*> **par_prev, Node **par_curr, Node **par_next, const int tid)
+    bool find (const SearchKey<T> &key, std::atomic<Node*> **par_prev, Node **par_curr, Node **par_next, const int tid)
     {
         std::atomic<Node*> *prev;
         Node *curr, *next;
@@ -196,11 +236,11 @@ private:
             next = he.protect(KHe0, curr->next, tid);
             if (prev->load() != curr) goto try_again;
             if (getUnmarked(next) == next) { // !cmark in the paper
-                if (curr->key != nullptr && !(*curr->key < *key)) { // Check for null to handle head
+                if (curr->key != nullptr && !(nodeKeyLess(curr, key))) { // Check for null to handle head
                     *par_curr = curr;
                     *par_prev = prev;
                     *par_next = next;
-                    return (*curr->key == *key);
+                    return (nodeKeyEqual(curr, key));
                 }
                 prev = &curr->next;
                 he.protectEraRelease(KHe2, KHe1, tid);
@@ -36,7 +36,11 @@
 #include <set>
 #include <iostream>
 #include <string>
+#include <vector>
+#include "BulkLoad.hpp"
 #include "HazardPointersOrig.hpp"
+#include "KeyPolicy.hpp"
+#include "Teardown.hpp"
 
 
 
@@ -62,11 +66,11 @@ template<typename T, size_t N = 1>
 class HarrisMichaelLinkedListHPO {
 
 private:
-    struct Node {
+    struct Node : ArenaNode, KeyPrefix<T> {
         T* key;
         std::atomic<Node*> next;
 
-        Node(T* key) : key{key}, next{nullptr} {}
+        Node(T* key) : KeyPrefix<T>(key), key{key}, next{nullptr} {}
     };
 
     alignas(128) std::atomic<Node*> head;
@@ -104,6 +108,33 @@ public:
     ~HarrisMichaelLinkedListHPO() {
     }
 
+    /**
+     * Frees the nodes still in the list and the nodes retired to the hazard pointers,
+     * with 'numThreads' threads. Only safe when no operation is in
+     * progress; the list can only be deleted afterwards.
+     */
+    void destroy(const int numThreads)
+    {
+        Teardown::freeList(head.load(), [](Node *node) { return unmarkPtr(node->next.load()); }, numThreads);
+        head.store(nullptr);
+        Teardown::freeRetired(hp, maxThreads, numThreads);
+    }
+
+    /**
+     * Links the nodes of 'keys', which are sorted and deduplicated with
+     * 'numThreads' threads, after the sentinel. Only for an empty list and
+     * when no operation is in progress.
+     */
+    void bulk_load(std::vector<T*> keys, const int numThreads)
+    {
+        BulkLoad::sortUnique(keys, numThreads);
+        BulkLoad::buildList(head.load(), keys, [](T *key, const int tid) {
+            return new (WITH_VALUE) Node(key);
+        }, [](Node *node, Node *next) {
+            node->next.store(next, std::memory_order_relaxed);
+        }, numThreads);
+    }
+
     std::string className() { return "HarrisMichaelLinkedListHPO"; }
 
 
@@ -117,11 +148,12 @@ public:
      */
     bool insert(T* key, const int tid)
     {
+        const SearchKey<T> skey(key);
         Node *curr, *next;
         std::atomic<Node*> *prev;
-        Node* newNode = new Node(key);
+        Node* newNode = new (WITH_VALUE) Node(key);
         while (true) {
-            if (find(key, &prev, &curr, &next, tid)) {
+            if (find(skey, &prev, &curr, &next, tid)) {
                 delete newNode;              // There is already a matching key
                 hp.clear(tid);
                 return false;
@@ -143,12 +175,13 @@ public:
      */
     bool remove(T* key, const int tid)
     {
+        const SearchKey<T> skey(key);
         Node *curr, *next;
         std::atomic<Node*> *prev;
         hp.take_snapshot(tid);
         while (true) {
             /* Try to find the key in the list. */
-            if (!find(key, &prev, &curr, &next, tid)) {
+            if (!find(skey, &prev, &curr, &next, tid)) {
                 hp.clear(tid);
                 return false;
             }
@@ -185,15 +218,21 @@ public:
      */
     bool search (T* key, const int tid)
     {
+        const SearchKey<T> skey(key);
         Node *curr, *next;
         std::atomic<Node*> *prev;
-        bool isContains = find(key, &prev, &curr, &next, tid);
+        bool isContains = find(skey, &prev, &curr, &next, tid);
+        if (isContains) readNodeValue(curr);
         hp.clear(tid);
         return isContains;
     }
 
     long long calculate_space(const int tid){
-        return hp.cal_space(sizeof(Node), tid);
+        return hp.cal_space(sizeof(Node) + NodeValue::size(), tid);
+    }
+
+    long long unreclaimed(const int tid){
+        return hp.cur_space(tid);
     }
 
 private:
@@ -203,7 +242,7 @@ private:
      * <p>
      * Progress Condition: Lock-Free
      */
-    bool find (T* key, std::atomic<Node*> **par_prev, Node **par_curr, Node **par_next, const int tid)
+    bool find (const SearchKey<T> &key, std::atomic<Node*> **par_prev, Node **par_curr, Node **par_next, const int tid)
     {
         std::atomic<Node*> *prev;
         Node *curr, *next;
@@ -218,11 +257,11 @@ try_again:
             next = hp.protect(kHp0, curr->next, tid);
             if (prev->load() != curr) goto try_again;
             if (unmarkPtr(next) == next) { // !cmark in the paper
-                if (curr->key != nullptr && !(*curr->key < *key)) { // Check for null to handle head
+                if (curr->key != nullptr && !(nodeKeyLess(curr, key))) { // Check for null to handle head
                     *par_curr = curr;
                     *par_prev = prev;
                     *par_next = next;
-                    return (*curr->key == *key);
+                    return (nodeKeyEqual(curr, key));
                 }
                 prev = &curr->next;
                 hp.protectPtrRelease(kHp2, curr, tid);
@@ -36,7 +36,11 @@
 #include <set>
 #include <iostream>
 #include <string>
+#include <vector>
+#include "BulkLoad.hpp"
 #include "Hyaline.hpp"
+#include "KeyPolicy.hpp"
+#include "Teardown.hpp"
 
 
 
@@ -62,11 +66,11 @@ template<typename T, size_t N = 1>
 class HarrisMichaelLinkedListHyaline {
 
 private:
-    struct Node : HyalineNode {
+    struct Node : HyalineNode, KeyPrefix<T> {
         T* key;
         std::atomic<Node*> next;
 
-        Node(T* key) : key{key}, next{nullptr} {}
+        Node(T* key) : KeyPrefix<T>(key), key{key}, next{nullptr} {}
     };
 
     alignas(128) std::atomic<Node*> head;
@@ -98,6 +102,34 @@ public:
     ~HarrisMichaelLinkedListHyaline() {
     }
 
+    /**
+     * Frees the nodes still in the list with 'numThreads' threads; Hyaline
+     * frees the retired nodes on its own. Only safe when no operation is
+     * in progress; the list can only be deleted afterwards.
+     */
+    void destroy(const int numThreads)
+    {
+        Teardown::freeList(head.load(), [](Node *node) { return unmarkPtr(node->next.load()); }, numThreads);
+        head.store(nullptr);
+    }
+
+    /**
+     * Links the nodes of 'keys', which are sorted and deduplicated with
+     * 'numThreads' threads, after the sentinel. Only for an empty list and
+     * when no operation is in progress.
+     * The builder threads pass their indices to Hyaline as tids, so
+     * 'numThreads' may not exceed maxThreads.
+     */
+    void bulk_load(std::vector<T*> keys, const int numThreads)
+    {
+        BulkLoad::sortUnique(keys, numThreads);
+        BulkLoad::buildList(head.load(), keys, [this](T *key, const int tid) {
+            return hyaline.init_object(new (WITH_VALUE) Node(key), tid);
+        }, [](Node *node, Node *next) {
+            node->next.store(next, std::memory_order_relaxed);
+        }, numThreads);
+    }
+
     std::string className() { return "HarrisMichaelLinkedListHYALINE"; }
 
 
@@ -111,12 +143,13 @@ public:
      */
     bool insert(T* key, const int tid)
     {
+        const SearchKey<T> skey(key);
         Node *curr, *next;
         std::atomic<Node*> *prev;
-        Node* newNode = hyaline.init_object(new Node(key), tid);
+        Node* newNode = hyaline.init_object(new (WITH_VALUE) Node(key), tid);
         hyaline.start_op(tid);
         while (true) {
-            if (find(key, &prev, &curr, &next, tid)) {
+            if (find(skey, &prev, &curr, &next, tid)) {
                 delete newNode;              // There is already a matching key
                 hyaline.end_op(tid);
                 return false;
@@ -138,6 +171,7 @@ public:
      */
     bool remove(T* key, const int tid)
     {
+        const SearchKey<T> skey(key);
         Node *curr, *next;
         std::atomic<Node*> *prev;
 
@@ -145,7 +179,7 @@ public:
         hyaline.take_snapshot(tid);
         while (true) {
             /* Try to find the key in the list. */
-            if (!find(key, &prev, &curr, &next, tid)) {
+            if (!find(skey, &prev, &curr, &next, tid)) {
                 hyaline.end_op(tid);
                 return false;
             }
@@ -182,16 +216,22 @@ public:
      */
     bool search (T* key, const int tid)
     {
+        const SearchKey<T> skey(key);
         Node *curr, *next;
         std::atomic<Node*> *prev;
         hyaline.start_op(tid);
-        bool isContains = find(key, &prev, &curr, &next, tid);
+        bool isContains = find(skey, &prev, &curr, &next, tid);
+        if (isContains) readNodeValue(curr);
         hyaline.end_op(tid);
         return isContains;
     }
     
     long long calculate_space(const int tid){
-        return hyaline.cal_space(sizeof(Node), tid);
+        return hyaline.cal_space(sizeof(Node) + NodeValue::size(), tid);
+    }
+
+    long long unreclaimed(const int tid){
+        return hyaline.cur_space(tid);
     }
     
 private:
@@ -201,7 +241,7 @@ private:
      * <p>
      * Progress Condition: Lock-Free
      */
-    bool find (T* key, std::atomic<Node*> **par_prev, Node **par_curr, Node **par_next, const int tid)
+    bool find (const SearchKey<T> &key, std::atomic<Node*> **par_prev, Node **par_curr, Node **par_next, const int tid)
     {
         std::atomic<Node*> *prev;
         Node *curr, *next;
@@ -216,11 +256,11 @@ try_again:
             next = hyaline.protect(curr->next, tid);
             if (prev->load() != curr) goto try_again;
             if (unmarkPtr(next) == next) { // !cmark in the paper
-                if (curr->key != nullptr && !(*curr->key < *key)) { // Check for null to handle head
+                if (curr->key != nullptr && !(nodeKeyLess(curr, key))) { // Check for null to handle head
                     *par_curr = curr;
                     *par_prev = prev;
                     *par_next = next;
-                    return (*curr->key == *key);
+                    return (nodeKeyEqual(curr, key));
                 }
                 prev = &curr->next;
             } else {
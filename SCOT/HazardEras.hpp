@@ -6,6 +6,9 @@
 #include <vector>
 #include <algorithm>
 #include <new> 
+#include "NodeArena.hpp"
+#include "CompactHeader.hpp"
+#include "Stall.hpp"
 
 /*
  * <h1> Optimized Hazard Eras </h1>
@@ -18,11 +21,17 @@
  * "Hazard Eras - Non-Blocking Memory Reclamation" by Pedro Ramalhete and Andreia Correia.
  */
 
-struct HENode {
+#ifdef SCOT_COMPACT_HEADER
+struct HENode : ArenaNode {
+    uint64_t newEra;
+};
+#else
+struct HENode : ArenaNode {
     struct HENode *smr_next;
     uint64_t newEra;
     uint64_t delEra;
 };
+#endif
 
 template<typename T>
 class HazardEras {
@@ -42,8 +51,20 @@ private:
     alignas(128) std::atomic<uint64_t>* he[HE_MAX_THREADS];
     alignas(128) char pad[0];
 
+#ifdef SCOT_COMPACT_HEADER
+    typedef struct he_retired {
+        HENode *obj;
+        uint64_t newEra;
+        uint64_t delEra;
+    } he_retired_t;
+#endif
+
     typedef struct retired_node_controller {
+#ifdef SCOT_COMPACT_HEADER
+        RetiredArray<he_retired_t> retired;
+#else
         HENode *first;
+#endif
         size_t epoch_counter;
         size_t list_counter;
         ssize_t sum;
@@ -56,17 +77,21 @@ private:
 
 public:
     HazardEras(int _maxHEs, int _maxThreads) : maxHEs{_maxHEs}, maxThreads{_maxThreads} {
-        rnc = static_cast<retired_node_controller_t*>(aligned_alloc(128, sizeof(retired_node_controller_t) * HE_MAX_THREADS));
+        rnc = static_cast<retired_node_controller_t*>(Numa::alloc_per_thread(sizeof(retired_node_controller_t), HE_MAX_THREADS));
         if (rnc == nullptr) {
             std::cerr << "Error: Failed to allocate memory for retired_node_controller_t array\n";
             exit(1);
         }
         for (int it = 0; it < HE_MAX_THREADS; it++) {
-            he[it] = new std::atomic<uint64_t>[CLPAD * 2];
+            he[it] = static_cast<std::atomic<uint64_t>*>(Numa::alloc_onnode(sizeof(std::atomic<uint64_t>) * CLPAD * 2, Numa::thread_node(it)));
             for (int ihe = 0; ihe < MAX_HES; ihe++) {
                 he[it][ihe].store(NONE, std::memory_order_relaxed);
             }
+#ifdef SCOT_COMPACT_HEADER
+            rnc[it].retired.init();
+#else
             rnc[it].first = nullptr;
+#endif
             rnc[it].epoch_counter = 0;
             rnc[it].list_counter = 0;
             rnc[it].sum = 0;
@@ -74,21 +99,42 @@ public:
             rnc[it].space = 0;
         }
         static_assert(std::is_same<decltype(T::newEra), uint64_t>::value, "T::newEra must be uint64_t");
+#ifndef SCOT_COMPACT_HEADER
         static_assert(std::is_same<decltype(T::delEra), uint64_t>::value, "T::delEra must be uint64_t");
+#endif
+    }
+
+    /**
+     * Frees the nodes retired by 'tid'. Only safe when no thread is in an
+     * operation, e.g., when the data structure is torn down.
+     */
+    inline void clear_retired(const int tid)
+    {
+#ifdef SCOT_COMPACT_HEADER
+        for (size_t i = 0; i < rnc[tid].retired.size(); i++) {
+            rnc[tid].space--;
+            delete rnc[tid].retired[i].obj;
+        }
+        rnc[tid].retired.release();
+#else
+        HENode *obj = rnc[tid].first;
+        while (obj != nullptr) {
+            HENode *smr_next = obj->smr_next;
+            rnc[tid].space--;
+            delete obj;
+            obj = smr_next;
+        }
+        rnc[tid].first = nullptr;
+#endif
     }
 
     ~HazardEras()
     {
-        for (int tid = 0; tid < maxThreads; tid++) {
-            HENode *obj = rnc[tid].first;
-            while (obj != nullptr) {
-                HENode *smr_next = obj->smr_next;
-                rnc[tid].space--;
-                delete obj;
-                obj = smr_next;
-            }
+        for (int tid = 0; tid < maxThreads; tid++) clear_retired(tid);
+        for (int it = 0; it < HE_MAX_THREADS; it++) {
+            Numa::free_onnode(he[it], sizeof(std::atomic<uint64_t>) * CLPAD * 2);
         }
-        free(rnc);
+        Numa::free_per_thread(rnc, sizeof(retired_node_controller_t), HE_MAX_THREADS);
     }
 
     inline T *init_object(T *obj, const int mytid)
@@ -104,13 +150,18 @@ public:
         }
     }
 
-    inline T* protect(int index, const std::atomic<T*>& atom, const int tid)
+    // 'atom' is a std::atomic<T*> or a CompactLink<T>
+    template<typename A>
+    inline T* protect(int index, const A& atom, const int tid)
     {
         auto prevEra = he[tid][index].load(std::memory_order_relaxed);
         while (true) {
             T* ptr = atom.load();
             auto era = eraClock.load(std::memory_order_acquire);
-            if (era == prevEra) return ptr;
+            if (era == prevEra) {
+                Stall::point(tid);
+                return ptr;
+            }
             he[tid][index].store(era);
             prevEra = era;
         }
@@ -137,17 +188,25 @@ public:
 
     void retire(T* ptr, const int mytid)
     {
+        RetireDelay::retired(ptr, mytid);
         rnc[mytid].space++;
         auto currEra = eraClock.load();
+#ifndef SCOT_COMPACT_HEADER
         ptr->delEra = currEra;
+#endif
         rnc[mytid].epoch_counter++;
         if (rnc[mytid].epoch_counter % (epoch_freq * maxThreads) == 0)
             eraClock.fetch_add(1);
 
+#ifdef SCOT_COMPACT_HEADER
+        rnc[mytid].retired.push({ptr, ptr->newEra, currEra});
+#else
         ptr->smr_next = rnc[mytid].first;
         rnc[mytid].first = ptr;
+#endif
         rnc[mytid].list_counter++;
         if (rnc[mytid].list_counter % HE_THRESHOLD_R != 0) return;
+        RetireDelay::scan(mytid);
 
         uint64_t he_eras[HE_MAX_THREADS * MAX_HES];
         uint64_t prev = NONE;
@@ -160,6 +219,25 @@ public:
             }
         }
 
+#ifdef SCOT_COMPACT_HEADER
+        RetiredArray<he_retired_t> &retired = rnc[mytid].retired;
+        size_t kept = 0;
+        for (size_t j = 0; j < retired.size(); j++) {
+            he_retired_t r = retired[j];
+            for (size_t i = 0; i < he_size; i++) {
+                const auto era = he_eras[i];
+                if (era >= r.newEra && era <= r.delEra) {
+                    retired[kept++] = r;
+                    goto next;
+                }
+            }
+            rnc[mytid].space--;
+            RetireDelay::freed(r.obj, mytid);
+            delete r.obj;
+next:       ;
+        }
+        retired.truncate(kept);
+#else
         HENode **prev_p = &rnc[mytid].first;
         HENode *obj = rnc[mytid].first;
         while (obj != nullptr) {
@@ -173,9 +251,11 @@ public:
             }
             rnc[mytid].space--;
             *prev_p = smr_next;
+            RetireDelay::freed(obj, mytid);
             delete obj;
 next:       obj = smr_next;
         }
+#endif
     }
 
     inline void take_snapshot(const int tid) {
@@ -183,8 +263,16 @@ next:       obj = smr_next;
         rnc[tid].count++;
     }
 
+    // Bytes retired by 'tid' and not yet freed, averaged over the snapshots;
+    // 'size' is the footprint of a retired node
     inline long long cal_space(size_t size, const int tid) {
-        return (long long) (rnc[tid].sum) / ((ssize_t) rnc[tid].count);
+        if (rnc[tid].count == 0) return 0; // no remove() took a snapshot
+        return (long long) ((double) rnc[tid].sum * size / rnc[tid].count);
+    }
+
+    // Nodes retired by 'tid' and not yet freed; may be read by other threads
+    inline long long cur_space(const int tid) {
+        return (long long) __atomic_load_n(&rnc[tid].space, __ATOMIC_RELAXED);
     }
 };
 
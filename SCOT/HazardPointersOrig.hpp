@@ -34,6 +34,8 @@
 #include <atomic>
 #include <iostream>
 #include <vector>
+#include "NodeArena.hpp"
+#include "Stall.hpp"
 
 
 template<typename T>
@@ -66,9 +68,9 @@ private:
 
 public:
     HazardPointersOrig(int maxHPs=HP_MAX_HPS, int maxThreads=HP_MAX_THREADS) : maxHPs{maxHPs}, maxThreads{maxThreads} {
-        rnc = static_cast<retired_node_controller_t*>(aligned_alloc(128, sizeof(retired_node_controller_t) * HP_MAX_THREADS));
+        rnc = static_cast<retired_node_controller_t*>(Numa::alloc_per_thread(sizeof(retired_node_controller_t), HP_MAX_THREADS));
         for (int it = 0; it < HP_MAX_THREADS; it++) {
-            hp[it] = new std::atomic<T*>[CLPAD*2];
+            hp[it] = static_cast<std::atomic<T*>*>(Numa::alloc_onnode(sizeof(std::atomic<T*>) * CLPAD * 2, Numa::thread_node(it)));
             retiredList[it*CLPAD].reserve(MAX_RETIRED);
             for (int ihp = 0; ihp < HP_MAX_HPS; ihp++) {
                 hp[it][ihp].store(nullptr, std::memory_order_relaxed);
@@ -81,15 +83,25 @@ public:
         }
     }
 
+    /**
+     * Frees the nodes retired by 'tid'. Only safe when no thread is in an
+     * operation, e.g., when the data structure is torn down.
+     */
+    inline void clear_retired(const int tid)
+    {
+        auto &list = retiredList[tid * CLPAD];
+        for (auto obj : list) {
+            delete obj;
+        }
+        list.clear();
+    }
+
     ~HazardPointersOrig() {
-        for (int tid = 0; tid < maxThreads; tid++) {
-            auto &list = retiredList[tid * CLPAD];
-            for (auto obj : list) {
-                delete obj;
-            }
-            list.clear();
+        for (int tid = 0; tid < maxThreads; tid++) clear_retired(tid);
+        for (int it = 0; it < HP_MAX_THREADS; it++) {
+            Numa::free_onnode(hp[it], sizeof(std::atomic<T*>) * CLPAD * 2);
         }
-        free(rnc);
+        Numa::free_per_thread(rnc, sizeof(retired_node_controller_t), HP_MAX_THREADS);
     }
 
 
@@ -112,15 +124,18 @@ public:
 
 
     /**
+     * 'atom' is a std::atomic<T*> or a CompactLink<T>
      * Progress Condition: lock-free
      */
-    inline T* protect(int index, const std::atomic<T*>& atom, const int tid) {
+    template<typename A>
+    inline T* protect(int index, const A& atom, const int tid) {
         T* n = nullptr;
         T* ret;
         while ((ret = atom.load()) != n) {
             hp[tid][index].store((T*)((size_t) ret & ~3ULL));
             n = ret;
         }
+        Stall::point(tid);
         return ret;
     }
 
@@ -148,10 +163,12 @@ public:
      * Progress Condition: wait-free bounded (by the number of threads squared)
      */
     void retire(T* ptr, const int tid) {
+        RetireDelay::retired(ptr, tid);
         rnc[tid].space++;
         retiredList[tid*CLPAD].push_back(ptr);
         rnc[tid].list_counter++;
         if (rnc[tid].list_counter % HP_THRESHOLD_R != 0 ) return;
+        RetireDelay::scan(tid);
 
         for (unsigned iret = 0; iret < retiredList[tid*CLPAD].size();) {
             auto obj = retiredList[tid*CLPAD][iret];
@@ -165,6 +182,7 @@ public:
             }
             rnc[tid].space--;
             retiredList[tid*CLPAD].erase(retiredList[tid*CLPAD].begin() + iret);
+            RetireDelay::freed(obj, tid);
             delete obj;
 next:       ;
         }
@@ -175,8 +193,16 @@ next:       ;
         rnc[tid].count++;
     }
 
+    // Bytes retired by 'tid' and not yet freed, averaged over the snapshots;
+    // 'size' is the footprint of a retired node
     inline long long cal_space(size_t size, const int tid){
-        return (long long) (rnc[tid].sum) / ((ssize_t) rnc[tid].count);
+        if (rnc[tid].count == 0) return 0; // no remove() took a snapshot
+        return (long long) ((double) rnc[tid].sum * size / rnc[tid].count);
+    }
+
+    // Nodes retired by 'tid' and not yet freed; may be read by other threads
+    inline long long cur_space(const int tid){
+        return (long long) __atomic_load_n(&rnc[tid].space, __ATOMIC_RELAXED);
     }
 };
 
@@ -30,8 +30,10 @@
 #include <atomic>
 #include <malloc.h>
 #include "hyaline/lfbsmro.h"
+#include "NodeArena.hpp"
+#include "Stall.hpp"
 
-struct HyalineNode : lfbsmro_node { };
+struct HyalineNode : lfbsmro_node, ArenaNode { };
 
 template<typename T>
 class Hyaline {
@@ -61,7 +63,7 @@ public:
         if (!(maxThreads & (maxThreads - 1))) SMR_ORDER--;
         SMR_EFREQ = epoch_freq * maxThreads;
         SMR_BATCH = maxThreads < empty_freq ? empty_freq : maxThreads + 1;
-        thr = static_cast<hyaline_private_data_t*>(aligned_alloc(128, sizeof(hyaline_private_data_t) * maxThreads));
+        thr = static_cast<hyaline_private_data_t*>(Numa::alloc_per_thread(sizeof(hyaline_private_data_t), maxThreads));
         if (thr == nullptr) {
             std::cerr << "Error: Failed to allocate memory for ibr_private_data_t array\n";
             exit(1);
@@ -83,7 +85,7 @@ public:
 
     ~Hyaline()
     {
-        free(thr);
+        Numa::free_per_thread(thr, sizeof(hyaline_private_data_t), maxThreads);
         free(smr);
     }
 
@@ -97,10 +99,13 @@ public:
     {
         size_t enter_num = tid;
         lfbsmro_enter(smr, &enter_num, SMR_ORDER, &thr[tid].handle, 0, LF_DONTCHECK);
+        Stall::point(tid);
     }
 
     inline void end_op(const int tid)
     {
+        RetireDelay::freeing(tid);
+        freeing_space() = &thr[tid].space;
         lfbsmro_leave(smr, tid, SMR_ORDER, thr[tid].handle, hyaline_free_node, 0, LF_DONTCHECK);
     }
 
@@ -109,8 +114,24 @@ public:
         return (T *)lfbsmro_deref(smr, tid, (uintptr_t *)&atom);
     }
 
+    // lfbsmro_deref() for a CompactLink<T>, which is not a uintptr_t
+    inline T *protect(const CompactLink<T> &link, const int tid)
+    {
+        lfepoch_t access = __lfepoch_load(&smr->vector[tid].access, memory_order_acquire);
+        while (true) {
+            T *value = link.load(std::memory_order_acquire);
+            lfepoch_t global = __lfepoch_load(&smr->global, memory_order_acquire);
+            if (access == global) return value;
+            access = __lfbsmro_access(smr, tid, access, global);
+        }
+    }
+
     void retire(T *ptr, const int tid)
     {
+        RetireDelay::retired(ptr, tid);
+        RetireDelay::freeing(tid);
+        __atomic_store_n(&thr[tid].space, thr[tid].space + 1, __ATOMIC_RELAXED);
+        freeing_space() = &thr[tid].space;
         lfbsmro_retire(smr, SMR_ORDER, ptr, hyaline_free_node, 0,
             &thr[tid].batch, SMR_BATCH);
     }
@@ -121,15 +142,38 @@ public:
         thr[tid].count++;
     }
 
+    // Bytes retired by 'tid' and not yet freed, averaged over the snapshots;
+    // 'size' is the footprint of a retired node
     inline long long cal_space(size_t size, const int tid)
     {
-        return (long long) (thr[tid].sum) / ((ssize_t) thr[tid].count);
+        if (thr[tid].count == 0) return 0; // no remove() took a snapshot
+        return (long long) ((double) thr[tid].sum * size / thr[tid].count);
+    }
+
+    // Nodes retired by 'tid' less the nodes freed by 'tid'; may be read by
+    // other threads. A batch is freed by whichever thread drops its last
+    // reference, without knowing who retired it, so one thread's count can
+    // go negative, but the sum over the threads is what is still unreclaimed.
+    inline long long cur_space(const int tid)
+    {
+        return (long long) __atomic_load_n(&thr[tid].space, __ATOMIC_RELAXED);
     }
 
 private:
+    // The space counter of the thread whose end_op() or retire() runs the free callbacks
+    static ssize_t *&freeing_space()
+    {
+        static thread_local ssize_t *space = nullptr;
+        return space;
+    }
+
     static void hyaline_free_node(struct lfbsmro *hdr, struct lfbsmro_node *smrnode)
     {
-        free(smrnode);
+        HyalineNode *node = static_cast<HyalineNode*>(smrnode);
+        RetireDelay::freed(node);
+        ssize_t *space = freeing_space();
+        if (space != nullptr) __atomic_store_n(space, *space - 1, __ATOMIC_RELAXED);
+        delete node;
     }
 };
 
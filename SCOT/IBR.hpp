@@ -29,12 +29,21 @@
 
 #include <atomic>
 #include <malloc.h>
+#include "NodeArena.hpp"
+#include "CompactHeader.hpp"
+#include "Stall.hpp"
 
-struct IBRNode {
+#ifdef SCOT_COMPACT_HEADER
+struct IBRNode : ArenaNode {
+    uint64_t birth_epoch;
+};
+#else
+struct IBRNode : ArenaNode {
     struct IBRNode *smr_next;
     uint64_t birth_epoch;
     uint64_t retired_epoch;
 };
+#endif
 
 template<typename T>
 class IBR {
@@ -51,8 +60,20 @@ private:
         alignas(128) char pad[0];
     } ibr_reservation_t;
 
+#ifdef SCOT_COMPACT_HEADER
+    typedef struct ibr_retired {
+        IBRNode *obj;
+        uint64_t birth_epoch;
+        uint64_t retired_epoch;
+    } ibr_retired_t;
+#endif
+
     typedef struct ibr_private_data {
+#ifdef SCOT_COMPACT_HEADER
+        RetiredArray<ibr_retired_t> retired;
+#else
         IBRNode *first;
+#endif
         size_t epoch_counter;
         size_t list_counter;
         ssize_t sum;
@@ -68,12 +89,12 @@ private:
 public:
     IBR(const int _maxThreads) : maxThreads{_maxThreads}
     {
-        thr = static_cast<ibr_private_data_t*>(aligned_alloc(128, sizeof(ibr_private_data_t) * maxThreads));
+        thr = static_cast<ibr_private_data_t*>(Numa::alloc_per_thread(sizeof(ibr_private_data_t), maxThreads));
         if (thr == nullptr) {
             std::cerr << "Error: Failed to allocate memory for ibr_private_data_t array\n";
             exit(1);
         }
-        epoch = static_cast<ibr_reservation_t*>(aligned_alloc(128, sizeof(ibr_reservation_t) * maxThreads));
+        epoch = static_cast<ibr_reservation_t*>(Numa::alloc_per_thread(sizeof(ibr_reservation_t), maxThreads));
         if (epoch == nullptr) {
             std::cerr << "Error: Failed to allocate memory for ibr_reservation_t array\n";
             exit(1);
@@ -81,7 +102,11 @@ public:
         for (int it = 0; it < maxThreads; it++) {
             epoch[it].low.store(UINT64_MAX, std::memory_order_relaxed);
             epoch[it].high.store(UINT64_MAX, std::memory_order_relaxed);
+#ifdef SCOT_COMPACT_HEADER
+            thr[it].retired.init();
+#else
             thr[it].first = nullptr;
+#endif
             thr[it].epoch_counter = 0;
             thr[it].list_counter = 0;
             thr[it].sum = 0;
@@ -89,22 +114,40 @@ public:
             thr[it].space = 0;
         }
         static_assert(std::is_same<decltype(T::birth_epoch), uint64_t>::value, "T::birth_epoch must be uint64_t");
+#ifndef SCOT_COMPACT_HEADER
         static_assert(std::is_same<decltype(T::retired_epoch), uint64_t>::value, "T::retired_epoch must be uint64_t");
+#endif
     }
 
-    ~IBR()
+    /**
+     * Frees the nodes retired by 'tid'. Only safe when no thread is in an
+     * operation, e.g., when the data structure is torn down.
+     */
+    inline void clear_retired(const int tid)
     {
-        for (int tid = 0; tid < maxThreads; tid++) {
-            IBRNode *obj = thr[tid].first;
-            while (obj != nullptr) {
-                IBRNode *smr_next = obj->smr_next;
-                thr[tid].space--;
-                delete obj;
-                obj = smr_next;
-            }
+#ifdef SCOT_COMPACT_HEADER
+        for (size_t i = 0; i < thr[tid].retired.size(); i++) {
+            thr[tid].space--;
+            delete thr[tid].retired[i].obj;
+        }
+        thr[tid].retired.release();
+#else
+        IBRNode *obj = thr[tid].first;
+        while (obj != nullptr) {
+            IBRNode *smr_next = obj->smr_next;
+            thr[tid].space--;
+            delete obj;
+            obj = smr_next;
         }
-        free(thr);
-        free(epoch);
+        thr[tid].first = nullptr;
+#endif
+    }
+
+    ~IBR()
+    {
+        for (int tid = 0; tid < maxThreads; tid++) clear_retired(tid);
+        Numa::free_per_thread(thr, sizeof(ibr_private_data_t), maxThreads);
+        Numa::free_per_thread(epoch, sizeof(ibr_reservation_t), maxThreads);
     }
 
     inline T *init_object(T *obj, const int mytid)
@@ -123,6 +166,7 @@ public:
         uint64_t era = global_epoch.load(std::memory_order_acquire);
         epoch[tid].low.store(era, std::memory_order_release);
         epoch[tid].high.store(era, std::memory_order_release);
+        Stall::point(tid);
     }
 
     inline void end_op(const int tid)
@@ -131,7 +175,9 @@ public:
         epoch[tid].high.store(UINT64_MAX, std::memory_order_release);
     }
 
-    inline T *protect(const std::atomic<T*> &atom, const int tid)
+    // 'atom' is a std::atomic<T*> or a CompactLink<T>
+    template<typename A>
+    inline T *protect(const A &atom, const int tid)
     {
         auto prevEra = epoch[tid].high.load(std::memory_order_relaxed);
         while (true) {
@@ -145,13 +191,19 @@ public:
 
     void retire(T *ptr, const int mytid)
     {
+        RetireDelay::retired(ptr, mytid);
         thr[mytid].space++;
         auto currEra = global_epoch.load(std::memory_order_acquire);
+#ifdef SCOT_COMPACT_HEADER
+        thr[mytid].retired.push({ptr, ptr->birth_epoch, currEra});
+#else
         ptr->retired_epoch = currEra;
         ptr->smr_next = thr[mytid].first;
         thr[mytid].first = ptr;
+#endif
         thr[mytid].list_counter++;
         if (thr[mytid].list_counter % empty_freq != 0) return;
+        RetireDelay::scan(mytid);
 
         uint64_t low[maxThreads], high[maxThreads];
         for (int tid = 0; tid < maxThreads; tid++) {
@@ -159,6 +211,21 @@ public:
             high[tid] = epoch[tid].high.load(std::memory_order_acquire);
         }
 
+#ifdef SCOT_COMPACT_HEADER
+        RetiredArray<ibr_retired_t> &retired = thr[mytid].retired;
+        size_t kept = 0;
+        for (size_t i = 0; i < retired.size(); i++) {
+            ibr_retired_t r = retired[i];
+            if (can_delete(r.birth_epoch, r.retired_epoch, mytid, low, high)) {
+                thr[mytid].space--;
+                RetireDelay::freed(r.obj, mytid);
+                delete r.obj;
+            } else {
+                retired[kept++] = r;
+            }
+        }
+        retired.truncate(kept);
+#else
         IBRNode **prev_p = &thr[mytid].first;
         IBRNode *obj = thr[mytid].first;
         while (obj != nullptr) {
@@ -166,12 +233,14 @@ public:
             if (can_delete(obj->birth_epoch, obj->retired_epoch, mytid, low, high)) {
                 thr[mytid].space--;
                 *prev_p = smr_next;
+                RetireDelay::freed(obj, mytid);
                 delete obj;
             } else {
                 prev_p = &obj->smr_next;
             }
             obj = smr_next;
         }
+#endif
     }
 
     inline void take_snapshot(const int tid)
@@ -180,9 +249,18 @@ public:
         thr[tid].count++;
     }
 
+    // Bytes retired by 'tid' and not yet freed, averaged over the snapshots;
+    // 'size' is the footprint of a retired node
     inline long long cal_space(size_t size, const int tid)
     {
-        return (long long) (thr[tid].sum) / ((ssize_t) thr[tid].count);
+        if (thr[tid].count == 0) return 0; // no remove() took a snapshot
+        return (long long) ((double) thr[tid].sum * size / thr[tid].count);
+    }
+
+    // Nodes retired by 'tid' and not yet freed; may be read by other threads
+    inline long long cur_space(const int tid)
+    {
+        return (long long) __atomic_load_n(&thr[tid].space, __ATOMIC_RELAXED);
     }
 
 private:
@@ -0,0 +1,242 @@
+/*
+ * Copyright (c) 2024-2025, Md Amit Hasan Arovi, Ruslan Nikolaev
+ * All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#ifndef _KEY_GENERATOR_H_
+#define _KEY_GENERATOR_H_
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <map>
+#include <mutex>
+#include <random>
+#include <string>
+#include <utility>
+
+/*
+ * Key distributions for the benchmark workers.
+ *
+ * KeyDistribution holds what the threads share: the configuration, the
+ * Zipfian constants (computed once per key range) and, for 'latest', the
+ * most recently inserted key. For 'latest', the prefill holds exactly the
+ * keys below the first fresh one, so the recent keys it picks are there.
+ * Each worker draws keys through its own KeyGenerator. All distributions
+ * return an index into the key range [0, n); index 0 is the hottest key
+ * where there is one, so the hot keys sit at the head of a list and along
+ * one tree path.
+ *
+ *   uniform                 every key is equally likely (the default)
+ *   zipf[:theta]            Zipfian, theta in (0, 1), 0.99 by default
+ *   hotspot[:frac[:prob]]   'prob' of the accesses go to the first 'frac'
+ *                           of the range (0.2 and 0.8 by default)
+ *   sequential              each thread walks the range in ascending order
+ *                           from its own starting point
+ *   window[:frac]           uniform within a window of 'frac' of the range
+ *                           (0.01 by default) that slides by its own size
+ *                           every second
+ *   latest[:theta]          inserts take the next key after the latest
+ *                           insert; other operations pick recent keys with
+ *                           a Zipfian distance from it
+ */
+class KeyDistribution {
+public:
+    enum Type {
+        DIST_UNIFORM = 0,
+        DIST_ZIPF = 1,
+        DIST_HOTSPOT = 2,
+        DIST_SEQUENTIAL = 3,
+        DIST_WINDOW = 4,
+        DIST_LATEST = 5
+    };
+
+    struct Config {
+        int type = DIST_UNIFORM;
+        double theta = 0.99;
+        double hotFraction = 0.2;
+        double hotProbability = 0.8;
+        double windowFraction = 0.01;
+    };
+
+    const Config cfg;
+    const uint64_t n;
+
+    // Zipfian constants, as in Gray et al., "Quickly Generating
+    // Billion-Record Synthetic Databases"
+    double alpha = 0, zetan = 0, eta = 0, half_pow_theta = 0;
+
+    alignas(128) std::atomic<uint64_t> latest {0};
+    alignas(128) std::chrono::steady_clock::time_point origin;
+    alignas(128) char pad[0];
+
+    KeyDistribution(const Config &config, uint64_t numKeys) : cfg(config), n{numKeys > 0 ? numKeys : 1}
+    {
+        if (cfg.type == DIST_ZIPF || cfg.type == DIST_LATEST) {
+            double zeta2 = 1 + std::pow(0.5, cfg.theta);
+            zetan = zeta(n, cfg.theta);
+            alpha = 1 / (1 - cfg.theta);
+            eta = (1 - std::pow(2.0 / n, 1 - cfg.theta)) / (1 - zeta2 / zetan);
+            half_pow_theta = std::pow(0.5, cfg.theta);
+        }
+        restart(0);
+    }
+
+    /**
+     * Sum of 1/i^theta for i in [1, n]. It takes O(n), so it is computed
+     * once per key range and theta rather than once per benchmark.
+     */
+    static double zeta(uint64_t n, double theta)
+    {
+        static std::mutex lock;
+        static std::map<std::pair<uint64_t, double>, double> cache;
+        std::lock_guard<std::mutex> guard(lock);
+        auto it = cache.find(std::make_pair(n, theta));
+        if (it != cache.end()) return it->second;
+        double sum = 0;
+        for (uint64_t i = 1; i <= n; i++)
+            sum += 1 / std::pow((double) i, theta);
+        cache[std::make_pair(n, theta)] = sum;
+        return sum;
+    }
+
+    /**
+     * Called before each run: 'filled' is the number of prefilled keys,
+     * after which 'latest' starts inserting
+     */
+    void restart(uint64_t filled)
+    {
+        latest.store(filled);
+        origin = std::chrono::steady_clock::now();
+    }
+
+    inline uint64_t zipf(double u) const
+    {
+        double uz = u * zetan;
+        if (uz < 1) return 0;
+        if (uz < 1 + half_pow_theta) return 1;
+        uint64_t rank = (uint64_t) (n * std::pow(eta * u - eta + 1, alpha));
+        return (rank < n) ? rank : n - 1;
+    }
+
+    static const char *name(int type)
+    {
+        static const char *names[] = { "uniform", "zipf", "hotspot", "sequential", "window", "latest" };
+        return names[type];
+    }
+
+    /**
+     * Parses "name[:param[:param]]"; returns false if it is malformed
+     */
+    static bool parse(const std::string &spec, Config &cfg)
+    {
+        std::string name = spec.substr(0, spec.find(':'));
+        double params[2];
+        int count = 0;
+        for (size_t pos = spec.find(':'); pos != std::string::npos && count < 2; pos = spec.find(':', pos + 1)) {
+            char *end;
+            params[count] = strtod(spec.c_str() + pos + 1, &end);
+            if (end == spec.c_str() + pos + 1) return false;
+            count++;
+        }
+        if (name == "uniform" && count == 0) {
+            cfg.type = DIST_UNIFORM;
+        } else if ((name == "zipf" || name == "latest") && count <= 1) {
+            cfg.type = (name == "zipf") ? DIST_ZIPF : DIST_LATEST;
+            if (count == 1) cfg.theta = params[0];
+            if (cfg.theta <= 0 || cfg.theta >= 1) return false;
+        } else if (name == "hotspot") {
+            cfg.type = DIST_HOTSPOT;
+            if (count >= 1) cfg.hotFraction = params[0];
+            if (count == 2) cfg.hotProbability = params[1];
+            if (cfg.hotFraction <= 0 || cfg.hotFraction > 1 || cfg.hotProbability < 0 || cfg.hotProbability > 1) return false;
+        } else if (name == "sequential" && count == 0) {
+            cfg.type = DIST_SEQUENTIAL;
+        } else if (name == "window" && count <= 1) {
+            cfg.type = DIST_WINDOW;
+            if (count == 1) cfg.windowFraction = params[0];
+            if (cfg.windowFraction <= 0 || cfg.windowFraction > 1) return false;
+        } else {
+            return false;
+        }
+        return true;
+    }
+};
+
+class KeyGenerator {
+private:
+    static const uint64_t WINDOW_CLOCK_OPS = 256;
+
+    KeyDistribution &dist;
+    std::mt19937_64 gen;
+    uint64_t seq;
+    uint64_t ops = 0;
+    uint64_t windowStart = 0;
+
+    inline double uniform01() { return (gen() >> 11) * (1.0 / 9007199254740992.0); }
+
+public:
+    KeyGenerator(KeyDistribution &d, uint64_t seed, int tid, int numThreads) :
+            dist(d), gen(seed), seq{d.n / (numThreads > 0 ? numThreads : 1) * tid} { }
+
+    /**
+     * Next key index; 'insert' tells 'latest' that the key is for an insert
+     */
+    inline uint64_t next(bool insert)
+    {
+        const uint64_t n = dist.n;
+        switch (dist.cfg.type) {
+        case KeyDistribution::DIST_ZIPF:
+            return dist.zipf(uniform01());
+        case KeyDistribution::DIST_HOTSPOT: {
+            uint64_t hot = (uint64_t) (dist.cfg.hotFraction * n);
+            if (hot == 0) hot = 1;
+            if (hot >= n || uniform01() < dist.cfg.hotProbability) return gen() % hot;
+            return hot + gen() % (n - hot);
+        }
+        case KeyDistribution::DIST_SEQUENTIAL:
+            return seq++ % n;
+        case KeyDistribution::DIST_WINDOW: {
+            uint64_t size = (uint64_t) (dist.cfg.windowFraction * n);
+            if (size == 0) size = 1;
+            if (ops++ % WINDOW_CLOCK_OPS == 0) {
+                double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - dist.origin).count();
+                windowStart = (uint64_t) (secs * size) % n;
+            }
+            return (windowStart + gen() % size) % n;
+        }
+        case KeyDistribution::DIST_LATEST: {
+            if (insert) return dist.latest.fetch_add(1, std::memory_order_relaxed) % n;
+            uint64_t last = dist.latest.load(std::memory_order_relaxed) + n - 1;
+            return (last - dist.zipf(uniform01())) % n;
+        }
+        default:
+            return gen() % n;
+        }
+    }
+};
+
+#endif /* _KEY_GENERATOR_H_ */
@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) 2024-2025, Md Amit Hasan Arovi, Ruslan Nikolaev
+ * All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#ifndef _KEY_POLICY_H_
+#define _KEY_POLICY_H_
+
+#include <cstdint>
+
+/*
+ * Key comparison for the data structures, which store 'T *key'.
+ *
+ * KeyPolicy<T> compares keys with operator< and operator== by default.
+ * A specialization may also provide an order-preserving 64-bit prefix
+ * (a <= b implies prefix(a) <= prefix(b)) and set HAS_PREFIX. Nodes then
+ * cache the prefix of their key, and a comparison only dereferences the
+ * node's key object when the prefixes are equal. For key types without
+ * a prefix, KeyPrefix is an empty base and costs nothing.
+ */
+template<typename T>
+struct KeyPolicy {
+    static const bool HAS_PREFIX = false;
+
+    static inline uint64_t prefix(const T &key) { return 0; }
+    static inline bool less(const T &a, const T &b) { return a < b; }
+    static inline bool equal(const T &a, const T &b) { return a == b; }
+};
+
+/*
+ * A search key with its prefix, computed once per operation so that a node
+ * whose prefix differs costs one 64-bit comparison. It converts from 'T *'.
+ */
+template<typename T, bool = KeyPolicy<T>::HAS_PREFIX>
+struct SearchKey {
+    const T *key;
+
+    SearchKey(const T *k) : key{k} { }
+};
+
+template<typename T>
+struct SearchKey<T, true> {
+    const T *key;
+    uint64_t prefix;
+
+    SearchKey(const T *k) : key{k}, prefix{KeyPolicy<T>::prefix(*k)} { }
+};
+
+template<typename T, bool = KeyPolicy<T>::HAS_PREFIX>
+struct KeyPrefix {
+    KeyPrefix(const T *key) { }
+
+    // Decides nothing: the keys must be compared in full
+    inline int prefixCompare(const SearchKey<T> &key) const { return 0; }
+};
+
+template<typename T>
+struct KeyPrefix<T, true> {
+    uint64_t keyPrefix;
+
+    KeyPrefix(const T *key) : keyPrefix{key != nullptr ? KeyPolicy<T>::prefix(*key) : 0} { }
+
+    // <0 or >0 if the node's key is smaller or larger than 'key', 0 if undecided
+    inline int prefixCompare(const SearchKey<T> &key) const {
+        return (keyPrefix < key.prefix) ? -1 : (keyPrefix > key.prefix);
+    }
+};
+
+/*
+ * Comparisons between a node (deriving from KeyPrefix<T>, with a non-null
+ * 'key') and a search key
+ */
+template<typename N, typename T>
+static inline bool nodeKeyLess(const N *node, const SearchKey<T> &key) {
+    int c = node->prefixCompare(key);
+    return (c != 0) ? (c < 0) : KeyPolicy<T>::less(*node->key, *key.key);
+}
+
+template<typename N, typename T>
+static inline bool keyLessThanNode(const SearchKey<T> &key, const N *node) {
+    int c = node->prefixCompare(key);
+    return (c != 0) ? (c > 0) : KeyPolicy<T>::less(*key.key, *node->key);
+}
+
+template<typename N, typename T>
+static inline bool nodeKeyEqual(const N *node, const SearchKey<T> &key) {
+    return node->prefixCompare(key) == 0 && KeyPolicy<T>::equal(*node->key, *key.key);
+}
+
+#endif /* _KEY_POLICY_H_ */
@@ -0,0 +1,150 @@
+/*
+ * Copyright (c) 2024-2025, Md Amit Hasan Arovi, Ruslan Nikolaev
+ * All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#ifndef _LATENCY_HISTOGRAM_H_
+#define _LATENCY_HISTOGRAM_H_
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+/*
+ * Log-linear latency histogram in the style of HdrHistogram.
+ *
+ * Values below 2^SUB_BITS ticks are counted exactly. Above that, every
+ * power of two is split into 2^(SUB_BITS-1) buckets, which bounds the
+ * relative error of a reported percentile by about 3%. Recording is an
+ * index computation and one increment on a thread-private array; the
+ * histograms of all threads are merged once the run is over.
+ *
+ * Time is measured in TSC ticks on x86 and in nanoseconds elsewhere;
+ * ticksPerNs() converts.
+ */
+class LatencyHistogram {
+public:
+    static const int SUB_BITS = 6;
+    static const uint64_t SUB_COUNT = 1ULL << SUB_BITS;
+    static const uint64_t HALF_COUNT = SUB_COUNT / 2;
+    static const size_t NUM_BUCKETS = SUB_COUNT + (64 - SUB_BITS) * HALF_COUNT;
+
+private:
+    uint64_t counts[NUM_BUCKETS];
+    uint64_t total;
+    uint64_t maxValue;
+
+    static inline size_t bucketOf(uint64_t v) {
+        if (v < SUB_COUNT) return (size_t) v;
+        int e = 63 - __builtin_clzll(v) - SUB_BITS + 1;
+        return (size_t) (SUB_COUNT + (e - 1) * HALF_COUNT + ((v >> e) - HALF_COUNT));
+    }
+
+    // The largest value that falls into bucket 'idx'
+    static inline uint64_t bucketTop(size_t idx) {
+        if (idx < SUB_COUNT) return idx;
+        uint64_t e = (idx - SUB_COUNT) / HALF_COUNT + 1;
+        uint64_t sub = (idx - SUB_COUNT) % HALF_COUNT + HALF_COUNT;
+        return ((sub + 1) << e) - 1;
+    }
+
+public:
+    LatencyHistogram() { reset(); }
+
+    void reset() {
+        memset(counts, 0, sizeof(counts));
+        total = 0;
+        maxValue = 0;
+    }
+
+    static inline uint64_t now() {
+#if defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+#else
+        return (uint64_t) std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+    }
+
+    /**
+     * Ticks of now() per nanosecond, measured once against steady_clock
+     */
+    static double ticksPerNs() {
+#if defined(__x86_64__) || defined(__i386__)
+        static double ratio = 0;
+        if (ratio == 0) {
+            auto t0 = std::chrono::steady_clock::now();
+            uint64_t c0 = now();
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            uint64_t c1 = now();
+            auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - t0).count();
+            ratio = (ns > 0) ? (double) (c1 - c0) / ns : 1.0;
+        }
+        return ratio;
+#else
+        return 1.0;
+#endif
+    }
+
+    inline void record(uint64_t ticks) {
+        counts[bucketOf(ticks)]++;
+        total++;
+        if (ticks > maxValue) maxValue = ticks;
+    }
+
+    void merge(const LatencyHistogram &other) {
+        for (size_t i = 0; i < NUM_BUCKETS; i++)
+            counts[i] += other.counts[i];
+        total += other.total;
+        if (other.maxValue > maxValue) maxValue = other.maxValue;
+    }
+
+    uint64_t count() const { return total; }
+
+    uint64_t max() const { return maxValue; }
+
+    /**
+     * The value (in ticks) at percentile 'p' (0-100), as the upper bound
+     * of its bucket
+     */
+    uint64_t percentile(double p) const {
+        if (total == 0) return 0;
+        uint64_t rank = (uint64_t) (p / 100. * total + 0.5);
+        if (rank == 0) rank = 1;
+        uint64_t seen = 0;
+        for (size_t i = 0; i < NUM_BUCKETS; i++) {
+            seen += counts[i];
+            if (seen >= rank) return std::min(bucketTop(i), maxValue);
+        }
+        return maxValue;
+    }
+};
+
+#endif /* _LATENCY_HISTOGRAM_H_ */
@@ -0,0 +1,228 @@
+/*
+ * Copyright (c) 2024-2025, Md Amit Hasan Arovi, Ruslan Nikolaev
+ * All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#ifndef _LAZY_LINKED_LIST_EBR_H_
+#define _LAZY_LINKED_LIST_EBR_H_
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "BulkLoad.hpp"
+#include "EBR.hpp"
+#include "KeyPolicy.hpp"
+#include "Teardown.hpp"
+
+/**
+ * The lazy list by Heller, Herlihy, Luchangco, Moir, Scherer and Shavit,
+ * "A Lazy Concurrent List-Based Set Algorithm" (OPODIS 2005), as a
+ * lock-based baseline for the lock-free lists.
+ *
+ * Updates traverse without locks, lock the predecessor and the current
+ * node, and validate that both are unmarked and still adjacent. A remove
+ * marks the node before it unlinks it, so contains() needs neither locks
+ * nor retries. The algorithm assumes garbage collection; here unlinked
+ * nodes are retired to EBR, and every operation runs inside start_op()
+ * and end_op().
+ * <p>
+ * This set has three operations:
+ * <ul>
+ * <li>add(x)      - Blocking
+ * <li>remove(x)   - Blocking
+ * <li>contains(x) - Wait-Free
+ * </ul><p>
+ */
+template<typename T, size_t N = 1>
+class LazyLinkedListEBR {
+
+private:
+    struct Node : EBRNode, KeyPrefix<T> {
+        T* key;
+        std::atomic<Node*> next;
+        std::atomic<bool> marked;
+        std::mutex lock;
+
+        Node(T* key) : KeyPrefix<T>(key), key{key}, next{nullptr}, marked{false} { }
+    };
+
+    // Head sentinel; the list ends with nullptr
+    alignas(128) Node* head;
+
+    const int maxThreads;
+
+    EBR ebr {maxThreads};
+
+public:
+    LazyLinkedListEBR(const int maxThreads) : maxThreads{maxThreads} {
+        head = new Node(nullptr);
+    }
+
+    ~LazyLinkedListEBR() {
+        Node* node = head;
+        while (node != nullptr) {
+            Node* next = node->next.load();
+            delete node;
+            node = next;
+        }
+    }
+
+    /**
+     * Frees the nodes still in the list and the nodes retired to EBR,
+     * with 'numThreads' threads. Only safe when no operation is in
+     * progress; the list can only be deleted afterwards.
+     */
+    void destroy(const int numThreads)
+    {
+        Teardown::freeList(head, [](Node *node) { return node->next.load(); }, numThreads);
+        head = nullptr;
+        Teardown::freeRetired(ebr, maxThreads, numThreads);
+    }
+
+    /**
+     * Links the nodes of 'keys', which are sorted and deduplicated with
+     * 'numThreads' threads, after the sentinel. Only for an empty list and
+     * when no operation is in progress.
+     */
+    void bulk_load(std::vector<T*> keys, const int numThreads)
+    {
+        BulkLoad::sortUnique(keys, numThreads);
+        BulkLoad::buildList(head, keys, [](T *key, const int tid) {
+            return new (WITH_VALUE) Node(key);
+        }, [](Node *node, Node *next) {
+            node->next.store(next, std::memory_order_relaxed);
+        }, numThreads);
+    }
+
+    std::string className() { return "LazyLinkedListEBR"; }
+
+    bool insert(T* key, const int tid)
+    {
+        const SearchKey<T> skey(key);
+        ebr.start_op(tid);
+        while (true) {
+            Node *pred, *curr;
+            find(skey, &pred, &curr);
+            lock(pred, curr);
+            if (validate(pred, curr)) {
+                bool inserted = false;
+                if (curr == nullptr || !nodeKeyEqual(curr, skey)) {
+                    Node* newNode = new (WITH_VALUE) Node(key);
+                    newNode->next.store(curr, std::memory_order_relaxed);
+                    pred->next.store(newNode, std::memory_order_release);
+                    inserted = true;
+                }
+                unlock(pred, curr);
+                ebr.end_op(tid);
+                return inserted;
+            }
+            unlock(pred, curr);
+        }
+    }
+
+    bool remove(T* key, const int tid)
+    {
+        const SearchKey<T> skey(key);
+        ebr.start_op(tid);
+        ebr.take_snapshot(tid);
+        while (true) {
+            Node *pred, *curr;
+            find(skey, &pred, &curr);
+            lock(pred, curr);
+            if (validate(pred, curr)) {
+                if (curr == nullptr || !nodeKeyEqual(curr, skey)) {
+                    unlock(pred, curr);
+                    ebr.end_op(tid);
+                    return false;
+                }
+                // The logical removal, which contains() goes by
+                curr->marked.store(true, std::memory_order_release);
+                pred->next.store(curr->next.load(std::memory_order_relaxed), std::memory_order_release);
+                unlock(pred, curr);
+                ebr.end_op(tid);
+                ebr.retire(curr, tid);
+                return true;
+            }
+            unlock(pred, curr);
+        }
+    }
+
+    /**
+     * Progress Condition: wait-free bounded by the length of the list
+     */
+    bool search(T* key, const int tid)
+    {
+        const SearchKey<T> skey(key);
+        ebr.start_op(tid);
+        Node* curr = head->next.load(std::memory_order_acquire);
+        while (curr != nullptr && nodeKeyLess(curr, skey)) {
+            curr = curr->next.load(std::memory_order_acquire);
+        }
+        bool isContains = (curr != nullptr && !curr->marked.load(std::memory_order_acquire) && nodeKeyEqual(curr, skey));
+        if (isContains) readNodeValue(curr);
+        ebr.end_op(tid);
+        return isContains;
+    }
+
+    long long calculate_space(const int tid) {
+        return ebr.cal_space(sizeof(Node) + NodeValue::size(), tid);
+    }
+
+    long long unreclaimed(const int tid) {
+        return ebr.cur_space(tid);
+    }
+
+private:
+    // 'pred' and 'curr' (nullptr at the end) with curr the first node whose key is not smaller
+    void find(const SearchKey<T> &key, Node **par_pred, Node **par_curr)
+    {
+        Node* pred = head;
+        Node* curr = pred->next.load(std::memory_order_acquire);
+        while (curr != nullptr && nodeKeyLess(curr, key)) {
+            pred = curr;
+            curr = curr->next.load(std::memory_order_acquire);
+        }
+        *par_pred = pred;
+        *par_curr = curr;
+    }
+
+    static inline void lock(Node* pred, Node* curr) {
+        pred->lock.lock();
+        if (curr != nullptr) curr->lock.lock();
+    }
+
+    static inline void unlock(Node* pred, Node* curr) {
+        if (curr != nullptr) curr->lock.unlock();
+        pred->lock.unlock();
+    }
+
+    static inline bool validate(Node* pred, Node* curr) {
+        return !pred->marked.load(std::memory_order_acquire) &&
+               (curr == nullptr || !curr->marked.load(std::memory_order_acquire)) &&
+               pred->next.load(std::memory_order_acquire) == curr;
+    }
+};
+
+#endif /* _LAZY_LINKED_LIST_EBR_H_ */
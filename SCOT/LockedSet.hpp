@@ -0,0 +1,150 @@
+/*
+ * Copyright (c) 2024-2025, Md Amit Hasan Arovi, Ruslan Nikolaev
+ * All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#ifndef _LOCKED_SET_H_
+#define _LOCKED_SET_H_
+
+#include <mutex>
+#include <set>
+#include <shared_mutex>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "BulkLoad.hpp"
+#include "KeyPolicy.hpp"
+
+/*
+ * Baselines around std::set, with the interface of the lock-free sets:
+ *
+ *   MutexSet        every operation takes one std::mutex
+ *   RWLockSet       searches share a reader-writer lock, updates take it
+ *                   exclusively (std::shared_timed_mutex, the C++14
+ *                   reader-writer lock)
+ *   SequentialSet   no synchronization at all; only correct with a single
+ *                   thread, which is how the benchmark runs it, as an
+ *                   upper bound for one thread
+ *
+ * The set stores the key pointers and frees its own nodes, so there is
+ * nothing to reclaim, and node values (--value) are not stored.
+ */
+template<typename T>
+struct KeyPtrLess {
+    inline bool operator()(const T *a, const T *b) const { return KeyPolicy<T>::less(*a, *b); }
+};
+
+struct NoLock {
+    inline void lock() { }
+    inline void unlock() { }
+};
+
+// Searches hold the lock exclusively unless it is a reader-writer lock
+template<typename Lock>
+struct SharedGuard : std::lock_guard<Lock> {
+    explicit SharedGuard(Lock &lock) : std::lock_guard<Lock>(lock) { }
+};
+
+template<>
+struct SharedGuard<std::shared_timed_mutex> : std::shared_lock<std::shared_timed_mutex> {
+    explicit SharedGuard(std::shared_timed_mutex &lock) : std::shared_lock<std::shared_timed_mutex>(lock) { }
+};
+
+template<typename T, typename Lock>
+class LockedSet {
+private:
+    alignas(128) Lock lock;
+    std::set<T*, KeyPtrLess<T>> set;
+
+public:
+    // Whether several threads may fill the set before the run
+    static const bool CONCURRENT_PREFILL = !std::is_same<Lock, NoLock>::value;
+
+    LockedSet(const int maxThreads) { }
+
+    bool insert(T* key, const int tid)
+    {
+        std::lock_guard<Lock> guard(lock);
+        return set.insert(key).second;
+    }
+
+    bool remove(T* key, const int tid)
+    {
+        std::lock_guard<Lock> guard(lock);
+        return set.erase(key) != 0;
+    }
+
+    bool search(T* key, const int tid)
+    {
+        SharedGuard<Lock> guard(lock);
+        return set.find(key) != set.end();
+    }
+
+    // The set frees its nodes when it is deleted
+    void destroy(const int numThreads) { }
+
+    // Sorted keys go in at the end of the tree, each in constant time
+    void bulk_load(std::vector<T*> keys, const int numThreads)
+    {
+        BulkLoad::sortUnique(keys, numThreads);
+        set.insert(keys.begin(), keys.end());
+    }
+
+    long long calculate_space(const int tid) { return 0; }
+
+    long long unreclaimed(const int tid) { return 0; }
+};
+
+template<typename T, size_t N = 1>
+class MutexSet : public LockedSet<T, std::mutex> {
+public:
+    MutexSet(const int maxThreads) : LockedSet<T, std::mutex>(maxThreads) { }
+    std::string className() { return "MutexSet"; }
+};
+
+template<typename T, size_t N = 1>
+class RWLockSet : public LockedSet<T, std::shared_timed_mutex> {
+public:
+    RWLockSet(const int maxThreads) : LockedSet<T, std::shared_timed_mutex>(maxThreads) { }
+    std::string className() { return "RWLockSet"; }
+};
+
+template<typename T, size_t N = 1>
+class SequentialSet : public LockedSet<T, NoLock> {
+public:
+    SequentialSet(const int maxThreads) : LockedSet<T, NoLock>(maxThreads) { }
+    std::string className() { return "SequentialSet"; }
+};
+
+/*
+ * CONCURRENT_PREFILL of a data structure, true for those that do not
+ * declare it
+ */
+template<typename L, typename = void>
+struct ConcurrentPrefill : std::true_type { };
+
+template<typename L>
+struct ConcurrentPrefill<L, typename std::enable_if<!L::CONCURRENT_PREFILL>::type> : std::false_type { };
+
+#endif /* _LOCKED_SET_H_ */
@@ -33,17 +33,20 @@
 #include <string>
 #include <vector>
 #include <climits>
+#include "BulkLoad.hpp"
 #include "HazardEras.hpp"
+#include "KeyPolicy.hpp"
+#include "Teardown.hpp"
 
 template<typename T, size_t N = 1> 
 class NatarajanMittalTreeHE {
 private:
-    struct Node : HENode {
+    struct Node : HENode, KeyPrefix<T> {
         const T *key;
-        std::atomic<Node*> left;
-        std::atomic<Node*> right;
+        NodeLink<Node> left;
+        NodeLink<Node> right;
 
-        Node(const T* k, Node* l, Node* r) : key(k), left(l), right(r) {};
+        Node(const T* k, Node* l, Node* r) : KeyPrefix<T>(k), key(k), left(l), right(r) {};
     };
 
     struct SeekRecord{
@@ -85,12 +88,12 @@ private:
         return (size_t) n & flags;
     }
 
-    static inline bool keyIsLess(const T *k1, const T *k2) {
-        return (k2 == NT_KEY_NULL) || (*k1 < *k2);
+    static inline bool keyIsLess(const SearchKey<T> &key, const Node *n) {
+        return (n->key == NT_KEY_NULL) || keyLessThanNode(key, n);
     }
 
-    static inline bool keyIsEqual(const T *k1, const T *k2) {
-        return (k2 != NT_KEY_NULL) && (*k1 == *k2);
+    static inline bool keyIsEqual(const SearchKey<T> &key, const Node *n) {
+        return (n->key != NT_KEY_NULL) && nodeKeyEqual(n, key);
     }
 
 public:
@@ -109,9 +112,42 @@ public:
         delete[] records;
     }
 
+    /**
+     * Frees the nodes still in the tree and the nodes retired to Hazard Eras,
+     * with 'numThreads' threads. Only safe when no operation is in
+     * progress; the tree can only be deleted afterwards.
+     */
+    void destroy(const int numThreads)
+    {
+        Teardown::freeTree(R, [](Node *node, Node **c) {
+            c[0] = unmarkPtr(node->left.load());
+            c[1] = unmarkPtr(node->right.load());
+        }, numThreads);
+        R = nullptr;
+        Teardown::freeRetired(he, maxThreads, numThreads);
+    }
+
+    /**
+     * Builds the tree from 'keys', which are sorted and deduplicated, with
+     * 'numThreads' threads, as a balanced subtree below S. Only for an
+     * empty tree and when no operation is in progress.
+     * The nodes get their birth eras from the current era clock.
+     */
+    void bulk_load(std::vector<T*> keys, const int numThreads)
+    {
+        BulkLoad::sortUnique(keys, numThreads);
+        Node *top = BulkLoad::buildTree(keys, [this](const T *key, const int tid) {
+            return he.init_object(new (WITH_VALUE) Node(key, nullptr, nullptr), tid);
+        }, [this](const T *key, Node *left, Node *right, const int tid) {
+            return he.init_object(new Node(key, left, right), tid);
+        }, numThreads);
+        // Inserts grow the keys below an internal node with the null key
+        if (top != nullptr) S->left.store(he.init_object(new Node(NT_KEY_NULL, top, S->left.load()), 0));
+    }
+
     std::string className() { return "NatarajanMittalTreeHE"; }
 
-    void seek(const T *key, const int tid)
+    void seek(const SearchKey<T> &key, const int tid)
     {
         SeekRecord *seekRecord = &records[tid];
 
@@ -119,15 +155,15 @@ again:
         seekRecord->ancestor = R;
         seekRecord->parent = he.protect(kHe2, R->left, tid);
         seekRecord->successor = seekRecord->parent;
-        std::atomic<Node*> *successorAddr = &R->left;
+        NodeLink<Node> *successorAddr = &R->left;
         he.protectEraRelease(kHe3, kHe2, tid);
         Node *parentField = he.protect(kHe1, S->left, tid);
         seekRecord->leaf = unmarkPtr(parentField);
-        std::atomic<Node*> *leafAddr = &S->left;
+        NodeLink<Node> *leafAddr = &S->left;
 
         Node *currentField = he.protect(kHe0, seekRecord->leaf->left, tid);
         Node *current = unmarkPtr(currentField);
-        std::atomic<Node*>* currentAddr = &seekRecord->leaf->left;
+        NodeLink<Node>* currentAddr = &seekRecord->leaf->left;
 
         while (current != nullptr) {
             if (!checkPtr(parentField, NT_TAG)) {
@@ -151,7 +187,7 @@ again:
             he.protectEraRelease(kHe1, kHe0, tid);
             parentField = currentField;
 
-            if (keyIsLess(key, current->key)) {
+            if (keyIsLess(key, current)) {
                 currentField = he.protect(kHe0, current->left, tid);
                 currentAddr = &current->left;
             } else {
@@ -164,19 +200,27 @@ again:
 
     bool search (const T *key, const int tid)
     {
+        const SearchKey<T> skey(key);
         SeekRecord* seekRecord = &records[tid];
-        seek(key, tid);
-        bool isContains = keyIsEqual(key, seekRecord->leaf->key);
+        seek(skey, tid);
+        bool isContains = keyIsEqual(skey, seekRecord->leaf);
+        if (isContains) readNodeValue(seekRecord->leaf);
         he.clear(tid);
         return isContains;
     }
 
     long long calculate_space(const int tid)
     {
-        return he.cal_space(sizeof(Node), tid);
+        // A remove retires a leaf, which carries the value, and an internal node
+        return he.cal_space(sizeof(Node) + NodeValue::size() / 2, tid);
+    }
+
+    long long unreclaimed(const int tid)
+    {
+        return he.cur_space(tid);
     }
 
-    bool cleanup(const T *key, const int tid)
+    bool cleanup(const SearchKey<T> &key, const int tid)
     {
         SeekRecord* seekRecord = &records[tid];
         Node* ancestor = seekRecord->ancestor;
@@ -184,11 +228,11 @@ again:
         Node* parent = seekRecord->parent;
         Node* leaf = seekRecord->leaf;
 
-        std::atomic<Node*> *successorAddr =
-            keyIsLess(key, ancestor->key) ? &ancestor->left : &ancestor->right;
+        NodeLink<Node> *successorAddr =
+            keyIsLess(key, ancestor) ? &ancestor->left : &ancestor->right;
 
-        std::atomic<Node*> *childAddr, *siblingAddr;
-        if (keyIsLess(key, parent->key)) {
+        NodeLink<Node> *childAddr, *siblingAddr;
+        if (keyIsLess(key, parent)) {
             childAddr = &parent->left;
             siblingAddr = &parent->right;
         } else {
@@ -203,8 +247,7 @@ again:
         }
 
         // tag the sibling edge
-        std::atomic<size_t> *_siblingAddr = (std::atomic<size_t> *) siblingAddr;
-        Node *node = (Node *) (_siblingAddr->fetch_or(NT_TAG) & (~NT_TAG));
+        Node *node = (Node *) ((size_t) link_fetch_or(siblingAddr, NT_TAG) & (~NT_TAG));
         // the previous value is untagged if necessary
         bool ret = successorAddr->compare_exchange_strong(successor, node);
         // reclaim the deleted edge
@@ -229,21 +272,22 @@ again:
 
     bool insert(const T *key, const int tid)
     {
+        const SearchKey<T> skey(key);
         SeekRecord *seekRecord = &records[tid];
         bool ret = false;
 
-        Node *newLeaf = he.init_object(new Node(key, nullptr, nullptr), tid);
+        Node *newLeaf = he.init_object(new (WITH_VALUE) Node(key, nullptr, nullptr), tid);
 
         while (true) {
-            seek(key, tid);
+            seek(skey, tid);
             Node *leaf = seekRecord->leaf;
             Node *parent = seekRecord->parent;
-            if (!keyIsEqual(key, leaf->key)) {
-                std::atomic<Node*> *childAddr = keyIsLess(key, parent->key) ?
+            if (!keyIsEqual(skey, leaf)) {
+                NodeLink<Node> *childAddr = keyIsLess(skey, parent) ?
                                 &parent->left : &parent->right;
 
                 Node *newLeft, *newRight;
-                if (keyIsLess(key, leaf->key)) {
+                if (keyIsLess(skey, leaf)) {
                     newLeft = newLeaf;
                     newRight = leaf;
                 } else {
@@ -252,7 +296,7 @@ again:
                 }
 
                 const T *newKey = leaf->key;
-                if (newKey != NT_KEY_NULL && *newKey < *key) {
+                if (newKey != NT_KEY_NULL && nodeKeyLess(leaf, skey)) {
                     newKey = key;
                 }
                 Node *newInternal = he.init_object(new Node(newKey, newLeft, newRight), tid);
@@ -265,7 +309,7 @@ again:
                     delete newInternal;
                     Node* child = childAddr->load();
                     if (unmarkPtr(child) == leaf && checkPtr(child, NT_TAG | NT_FLG)) {
-                        cleanup(key, tid);
+                        cleanup(skey, tid);
                     }
                 }
             }
@@ -281,34 +325,35 @@ again:
 
     bool remove(const T *key, const int tid)
     {
+        const SearchKey<T> skey(key);
         SeekRecord* seekRecord = &records[tid];
         Node *leaf = nullptr; // injection
 
         he.take_snapshot(tid);
         while (true) {
-            seek(key, tid);
+            seek(skey, tid);
             Node *parent = seekRecord->parent;
-            std::atomic<Node*>* childAddr = keyIsLess(key, parent->key) ?
+            NodeLink<Node>* childAddr = keyIsLess(skey, parent) ?
                             &parent->left : &parent->right;
 
             if (!leaf) { // injection
                 leaf = seekRecord->leaf;
 
-                if (!keyIsEqual(key, leaf->key)) {
+                if (!keyIsEqual(skey, leaf)) {
                     he.clear(tid);
                     return false;
                 }
 
                 Node *tmpOld = leaf;
                 if (childAddr->compare_exchange_strong(tmpOld, markPtr(tmpOld, NT_FLG))) {
-                    if (cleanup(key, tid)) {
+                    if (cleanup(skey, tid)) {
                         he.clear(tid);
                         return true;
                     }
                 } else {
                     Node *child = childAddr->load();
                     if (unmarkPtr(child) == leaf && checkPtr(child, NT_TAG | NT_FLG)) {
-                        cleanup(key, tid);
+                        cleanup(skey, tid);
                     }
                     leaf = nullptr; // failed: reset injection
                 }
@@ -317,7 +362,7 @@ again:
                     he.clear(tid);
                     return true;
                 } else {
-                    if (cleanup(key, tid)) {
+                    if (cleanup(skey, tid)) {
                         he.clear(tid);
                         return true;
                     }
@@ -0,0 +1,518 @@
+/*
+ * Copyright (c) 2024-2025, Md Amit Hasan Arovi, Ruslan Nikolaev
+ * All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#ifndef _NODE_ARENA_H_
+#define _NODE_ARENA_H_
+
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <new>
+#include <sys/mman.h>
+#include "Numa.hpp"
+#include "RetireDelay.hpp"
+
+#ifndef MAP_HUGETLB
+#define MAP_HUGETLB 0x40000
+#endif
+
+#ifndef MADV_HUGEPAGE
+#define MADV_HUGEPAGE 14
+#endif
+
+/*
+ * Per-thread node arenas backed by 2 MB regions.
+ *
+ * Regions are carved out of one reserved virtual range and are either
+ * MAP_HUGETLB pages or regular pages marked with MADV_HUGEPAGE (THP).
+ * Every region serves a single size class of a single thread, and its
+ * header records the owner, so a node freed by any
+ * thread goes back to the arena it came from. That keeps the huge-page
+ * footprint dense. Nodes freed by another thread are handed back to the
+ * owner in batches rather than one CAS per node.
+ *
+ * Threads that never called bind() share one extra arena under a lock.
+ * When the arena is off, nodes come from the regular heap.
+ *
+ * With SCOT_COMPACT_LINKS, the arena is limited to COMPACT_RANGE so that
+ * any node can be named by a 32-bit reference (see CompactLink below).
+ */
+class NodeArena {
+public:
+    enum Mode {
+        ARENA_OFF = 0,
+        ARENA_THP = 1,
+        ARENA_HUGETLB = 2
+    };
+
+    static const size_t REGION_SIZE = 2UL << 20;
+    static const size_t RESERVE_SIZE = 1UL << 38; // 256 GB of address space
+    static const int    MAX_ARENAS = 1024;
+    static const size_t CLASS_UNIT = 16;
+    static const size_t NUM_CLASSES = 16;         // objects up to 256 bytes
+    static const size_t REMOTE_SLOTS = 64;
+    static const size_t REMOTE_BATCH = 64;
+    static const size_t COMPACT_RANGE = 1UL << 34; // 16 GB for 32-bit references
+
+private:
+    struct FreeObj {
+        FreeObj *next;
+    };
+
+    typedef struct region_header {
+        int owner;
+        size_t size_class;
+        alignas(64) char pad[0];
+    } region_header_t;
+
+    typedef struct size_class {
+        char *bump;
+        char *end;
+        FreeObj *free;
+        alignas(128) std::atomic<FreeObj*> remote;
+        alignas(128) char pad[0];
+    } size_class_t;
+
+    // Nodes on their way back to another arena
+    typedef struct remote_batch {
+        FreeObj *head;
+        FreeObj *tail;
+        size_t count;
+        size_class_t *dest;
+    } remote_batch_t;
+
+    typedef struct arena {
+        size_class_t cls[NUM_CLASSES];
+        remote_batch_t pending[REMOTE_SLOTS];
+        alignas(128) char pad[0];
+    } arena_t;
+
+    int mode = ARENA_OFF;
+    char *base = nullptr;
+    char *limit = nullptr;
+    arena_t *arenas = nullptr;
+    alignas(128) std::atomic<size_t> next_region {0};
+    std::atomic<size_t> huge_regions {0};
+    alignas(128) std::atomic<bool> shared_lock {false};
+    // Whether a node went to the heap since reset(), and whether frees of
+    // arena nodes are skipped because reset() is about to drop them
+    alignas(128) std::atomic<bool> heap_nodes {false};
+    std::atomic<bool> discarding {false};
+    alignas(128) char pad[0];
+
+    static NodeArena &get() {
+        static NodeArena instance;
+        return instance;
+    }
+
+    static int &thread_slot() {
+        static thread_local int slot = -1;
+        return slot;
+    }
+
+public:
+    /**
+     * Reserves the address range and turns the arena on. Must be called
+     * before any node is allocated.
+     */
+    static bool enable(Mode m)
+    {
+        NodeArena &na = get();
+        if (m == ARENA_OFF || na.mode != ARENA_OFF) return true;
+        void *range = mmap(nullptr, RESERVE_SIZE + REGION_SIZE, PROT_NONE,
+                        MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+        if (range == MAP_FAILED) {
+            std::cerr << "Error: Failed to reserve address space for the node arena\n";
+            return false;
+        }
+        na.arenas = static_cast<arena_t*>(aligned_alloc(128, sizeof(arena_t) * (MAX_ARENAS + 1)));
+        if (na.arenas == nullptr) {
+            std::cerr << "Error: Failed to allocate memory for arena_t array\n";
+            exit(1);
+        }
+        na.base = (char *) (((uintptr_t) range + REGION_SIZE - 1) & ~(REGION_SIZE - 1));
+        na.limit = na.base + RESERVE_SIZE;
+#ifdef SCOT_COMPACT_LINKS
+        na.limit = na.base + COMPACT_RANGE;
+#endif
+        na.mode = m;
+        reset();
+        return true;
+    }
+
+    static int current_mode() { return get().mode; }
+
+    /**
+     * Makes the calling thread allocate from arena 'tid'. The benchmark
+     * never runs two threads with the same tid at the same time.
+     */
+    static inline void bind(const int tid)
+    {
+        thread_slot() = (tid < MAX_ARENAS) ? tid : -1;
+    }
+
+    /**
+     * Hands the nodes that the calling thread batched for other arenas
+     * back to them and detaches it. A thread that called bind() must call
+     * this before it exits, or partly filled batches are never reused.
+     */
+    static inline void unbind()
+    {
+        NodeArena &na = get();
+        int id = thread_slot();
+        if (na.mode != ARENA_OFF && id >= 0) {
+            for (size_t slot = 0; slot < REMOTE_SLOTS; slot++) flush(&na.arenas[id].pending[slot]);
+        }
+        thread_slot() = -1;
+    }
+
+    /**
+     * Nodes larger than the size classes come from the heap, and reset()
+     * does not free them. If spilled(), a teardown has to visit the nodes;
+     * discard() makes it free only the heap ones.
+     */
+    static bool spilled() { return get().heap_nodes.load(); }
+
+    static void discard() { get().discarding.store(true); }
+
+    /**
+     * Forgets every node at once, keeping the regions mapped for reuse.
+     * Only safe when no data structure refers to the arena anymore.
+     */
+    static void reset()
+    {
+        NodeArena &na = get();
+        if (na.mode == ARENA_OFF) return;
+        na.heap_nodes.store(false);
+        na.discarding.store(false);
+        for (int id = 0; id <= MAX_ARENAS; id++) {
+            for (size_t sc = 0; sc < NUM_CLASSES; sc++) {
+                size_class_t *c = &na.arenas[id].cls[sc];
+                c->bump = nullptr;
+                c->end = nullptr;
+                c->free = nullptr;
+                c->remote.store(nullptr, std::memory_order_relaxed);
+            }
+            for (size_t slot = 0; slot < REMOTE_SLOTS; slot++) {
+                remote_batch_t *b = &na.arenas[id].pending[slot];
+                b->head = nullptr;
+                b->tail = nullptr;
+                b->count = 0;
+                b->dest = nullptr;
+            }
+        }
+        na.next_region.store(0);
+        na.huge_regions.store(0);
+    }
+
+    static size_t regions() { return get().next_region.load(); }
+
+    static size_t hugetlb_regions() { return get().huge_regions.load(); }
+
+    static inline bool contains(const void *ptr)
+    {
+        NodeArena &na = get();
+        return (const char *) ptr >= na.base && (const char *) ptr < na.limit;
+    }
+
+    /**
+     * Nodes are 16-byte aligned, so (offset >> 2) keeps the two low bits
+     * free for the pointer's mark bits. The first region starts with a
+     * header, hence offset 0 never names a node and encodes nullptr.
+     */
+    static inline uint32_t compress(const void *ptr)
+    {
+        uintptr_t marks = (uintptr_t) ptr & 3;
+        if (((uintptr_t) ptr & ~(uintptr_t) 3) == 0) return (uint32_t) marks;
+        // Nodes past the size classes come from the heap and have no offset
+        assert(contains((const char *) ptr - marks));
+        return (uint32_t) (((uintptr_t) ptr - marks - (uintptr_t) get().base) >> 2) | (uint32_t) marks;
+    }
+
+    static inline void *expand(uint32_t ref)
+    {
+        uintptr_t marks = ref & 3;
+        if ((ref & ~3U) == 0) return (void *) marks;
+        return get().base + ((uintptr_t) (ref & ~3U) << 2) + marks;
+    }
+
+    static inline void *allocate(size_t size)
+    {
+        NodeArena &na = get();
+        if (na.mode == ARENA_OFF) return ::operator new(size);
+        if (size > CLASS_UNIT * NUM_CLASSES) {
+            if (!na.heap_nodes.load(std::memory_order_relaxed)) na.heap_nodes.store(true, std::memory_order_relaxed);
+            return ::operator new(size);
+        }
+        size_t sc = (size - 1) / CLASS_UNIT;
+        int id = thread_slot();
+        if (id >= 0) return na.alloc_from(id, sc);
+        while (na.shared_lock.exchange(true, std::memory_order_acquire)) { }
+        void *ptr = na.alloc_from(MAX_ARENAS, sc);
+        na.shared_lock.store(false, std::memory_order_release);
+        return ptr;
+    }
+
+    static inline void deallocate(void *ptr)
+    {
+        if (ptr == nullptr) return;
+        if (!contains(ptr)) {
+            ::operator delete(ptr);
+            return;
+        }
+        NodeArena &na = get();
+        if (na.discarding.load(std::memory_order_relaxed)) return;
+        region_header_t *hdr = (region_header_t *) ((uintptr_t) ptr & ~(REGION_SIZE - 1));
+        size_class_t *c = &na.arenas[hdr->owner].cls[hdr->size_class];
+        FreeObj *obj = static_cast<FreeObj*>(ptr);
+        int id = thread_slot();
+        if (hdr->owner == id) {
+            obj->next = c->free;
+            c->free = obj;
+            return;
+        }
+        if (id < 0) {
+            push_remote(c, obj, obj);
+            return;
+        }
+        remote_batch_t *b = &na.arenas[id].pending[(hdr->owner * NUM_CLASSES + hdr->size_class) % REMOTE_SLOTS];
+        if (b->dest != c) {
+            flush(b);
+            b->dest = c;
+        }
+        obj->next = b->head;
+        if (b->head == nullptr) b->tail = obj;
+        b->head = obj;
+        if (++b->count == REMOTE_BATCH) flush(b);
+    }
+
+private:
+    static inline void push_remote(size_class_t *c, FreeObj *first, FreeObj *last)
+    {
+        FreeObj *head = c->remote.load(std::memory_order_relaxed);
+        do {
+            last->next = head;
+        } while (!c->remote.compare_exchange_weak(head, first, std::memory_order_release, std::memory_order_relaxed));
+    }
+
+    static inline void flush(remote_batch_t *b)
+    {
+        if (b->count == 0) return;
+        push_remote(b->dest, b->head, b->tail);
+        b->head = nullptr;
+        b->tail = nullptr;
+        b->count = 0;
+    }
+
+    inline void *alloc_from(const int id, size_t sc)
+    {
+        size_class_t *c = &arenas[id].cls[sc];
+        FreeObj *obj = c->free;
+        if (obj == nullptr && c->remote.load(std::memory_order_relaxed) != nullptr)
+            obj = c->remote.exchange(nullptr, std::memory_order_acquire);
+        if (obj != nullptr) {
+            c->free = obj->next;
+            return obj;
+        }
+        size_t size = (sc + 1) * CLASS_UNIT;
+        if (c->bump + size > c->end) {
+            char *region = new_region(id, sc);
+            c->bump = region + sizeof(region_header_t);
+            c->end = region + REGION_SIZE;
+        }
+        void *ptr = c->bump;
+        c->bump += size;
+        return ptr;
+    }
+
+    char *new_region(const int id, size_t sc)
+    {
+        size_t idx = next_region.fetch_add(1);
+        char *region = base + idx * REGION_SIZE;
+        if (region + REGION_SIZE > limit) {
+            std::cerr << "Error: Node arena is exhausted\n";
+            exit(1);
+        }
+        int node = Numa::current_node();
+        bool huge = false;
+        if (mode == ARENA_HUGETLB) {
+            huge = mmap(region, REGION_SIZE, PROT_READ | PROT_WRITE,
+                    MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED | MAP_HUGETLB, -1, 0) != MAP_FAILED;
+        }
+        if (huge) {
+            huge_regions.fetch_add(1);
+        } else {
+            // A failed MAP_FIXED may have dropped the reservation, so map again
+            if (mmap(region, REGION_SIZE, PROT_READ | PROT_WRITE,
+                    MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED, -1, 0) == MAP_FAILED) {
+                std::cerr << "Error: Failed to map a node arena region\n";
+                exit(1);
+            }
+            madvise(region, REGION_SIZE, MADV_HUGEPAGE);
+        }
+        // Place the region before the header write faults it in
+        Numa::bind(region, REGION_SIZE, node);
+        region_header_t *hdr = reinterpret_cast<region_header_t*>(region);
+        hdr->owner = id;
+        hdr->size_class = sc;
+        return region;
+    }
+};
+
+/*
+ * Values for key-value workloads.
+ *
+ * Nodes allocated with 'new (WITH_VALUE) Node(...)' (list nodes and tree
+ * leaves) carry NodeValue::size() bytes right after the node object. The
+ * allocation writes the value, a successful search copies it out while
+ * the node is still protected, and it is freed together with the node,
+ * so a retired node keeps its value allocated. The size is 0, i.e. plain
+ * sets, unless --value is given.
+ */
+struct with_value_t { };
+static const with_value_t WITH_VALUE = { };
+
+class NodeValue {
+public:
+    static const size_t MAX_SIZE = 16384;
+    // Room kept for a node ahead of its value; the largest, a lazy list node with retire stamps, takes 112 bytes
+    static const size_t NODE_ROOM = 128;
+
+private:
+    static size_t &bytes() {
+        static size_t n = 0;
+        return n;
+    }
+
+    static char *buffer() {
+        static thread_local char buf[MAX_SIZE];
+        return buf;
+    }
+
+public:
+    static void configure(size_t n) { bytes() = n; }
+
+    static inline size_t size() { return bytes(); }
+
+    static inline void write(void *value) { memset(value, 0x5a, size()); }
+
+    static inline void read(const void *value) { memcpy(buffer(), value, size()); }
+};
+
+/*
+ * Nodes deriving from ArenaNode are allocated through NodeArena.
+ * Reclamation schemes free them with a plain 'delete', which picks up
+ * this operator delete even through a base pointer. The bench_delay
+ * build adds the RetireStamp of RetireDelay.hpp.
+ */
+struct ArenaNode {
+#ifdef SCOT_RETIRE_DELAY
+    RetireStamp retire_stamp;
+#endif
+    static void *operator new(size_t size) { return NodeArena::allocate(size); }
+    static void operator delete(void *ptr) { NodeArena::deallocate(ptr); }
+
+    static void *operator new(size_t size, with_value_t)
+    {
+        void *ptr = NodeArena::allocate(size + NodeValue::size());
+        if (NodeValue::size() != 0) NodeValue::write((char *) ptr + size);
+        return ptr;
+    }
+    static void operator delete(void *ptr, with_value_t) { NodeArena::deallocate(ptr); }
+};
+
+// The value of a node allocated with WITH_VALUE
+template<typename N>
+static inline void readNodeValue(const N *node)
+{
+    if (NodeValue::size() != 0) NodeValue::read((const char *) node + sizeof(N));
+}
+
+/*
+ * A 32-bit node reference with the std::atomic<N*> operations used by
+ * the data structures. Mark bits travel in the low two bits, as with
+ * regular pointers. Only valid for nodes allocated from NodeArena.
+ */
+template<typename N>
+class CompactLink {
+private:
+    std::atomic<uint32_t> ref;
+
+public:
+    CompactLink(N *ptr = nullptr) : ref{NodeArena::compress(ptr)} { }
+
+    inline N *load(std::memory_order order = std::memory_order_seq_cst) const
+    {
+        return static_cast<N*>(NodeArena::expand(ref.load(order)));
+    }
+
+    inline void store(N *ptr, std::memory_order order = std::memory_order_seq_cst)
+    {
+        ref.store(NodeArena::compress(ptr), order);
+    }
+
+    inline operator N*() const { return load(); }
+
+    inline bool compare_exchange_strong(N *&expected, N *desired)
+    {
+        uint32_t old = NodeArena::compress(expected);
+        if (ref.compare_exchange_strong(old, NodeArena::compress(desired)))
+            return true;
+        expected = static_cast<N*>(NodeArena::expand(old));
+        return false;
+    }
+
+    inline N *fetch_or(size_t bits)
+    {
+        return static_cast<N*>(NodeArena::expand(ref.fetch_or((uint32_t) bits)));
+    }
+};
+
+#ifdef SCOT_COMPACT_LINKS
+template<typename N> using NodeLink = CompactLink<N>;
+#else
+template<typename N> using NodeLink = std::atomic<N*>;
+#endif
+
+/*
+ * Sets mark bits in a link and returns its previous value
+ */
+template<typename N>
+static inline N *link_fetch_or(std::atomic<N*> *link, size_t bits)
+{
+    return (N *) ((std::atomic<size_t> *) link)->fetch_or(bits);
+}
+
+template<typename N>
+static inline N *link_fetch_or(CompactLink<N> *link, size_t bits)
+{
+    return link->fetch_or(bits);
+}
+
+#endif /* _NODE_ARENA_H_ */
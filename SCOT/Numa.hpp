@@ -0,0 +1,199 @@
+/*
+ * Copyright (c) 2024-2025, Md Amit Hasan Arovi, Ruslan Nikolaev
+ * All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#ifndef _NUMA_H_
+#define _NUMA_H_
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+/*
+ * NUMA placement without libnuma: the node layout comes from sysfs and
+ * memory is placed with the raw mbind(2) system call.
+ *
+ * Benchmark thread 'tid' is expected to run on online CPU 'tid' (modulo the
+ * number of CPUs), or on the CPU that the pinning policy assigns to it (see
+ * Topology.hpp). Per-thread structures are placed on that CPU's node.
+ * On single-node machines, or when NUMA placement is off, every function
+ * falls back to plain aligned_alloc()/free().
+ */
+class Numa {
+private:
+    static const int MAX_NODES = 1024;
+    static const int MPOL_PREFERRED_ = 1;
+    static const size_t PAGE = 4096;
+
+    bool active = false;
+    int numNodes = 1;
+    std::vector<int> cpuNode;
+    std::vector<int> threadCpu;
+
+    static Numa &get() {
+        static Numa instance;
+        return instance;
+    }
+
+    Numa()
+    {
+        long ncpus = sysconf(_SC_NPROCESSORS_CONF);
+        cpuNode.assign(ncpus > 0 ? ncpus : 1, 0);
+        for (int node = 0; node < MAX_NODES; node++) {
+            char path[64];
+            snprintf(path, sizeof(path), "/sys/devices/system/node/node%d/cpulist", node);
+            FILE *f = fopen(path, "r");
+            if (f == nullptr) continue;
+            numNodes = node + 1;
+            int lo, hi;
+            char sep;
+            while (fscanf(f, "%d", &lo) == 1) {
+                hi = lo;
+                if (fscanf(f, "%c", &sep) == 1 && sep == '-') {
+                    if (fscanf(f, "%d", &hi) != 1) break;
+                    if (fscanf(f, "%c", &sep) != 1) sep = '\n';
+                }
+                for (int cpu = lo; cpu <= hi && cpu < (int) cpuNode.size(); cpu++)
+                    cpuNode[cpu] = node;
+                if (sep != ',') break;
+            }
+            fclose(f);
+        }
+    }
+
+    static size_t pageRound(size_t size) {
+        return (size + PAGE - 1) & ~(PAGE - 1);
+    }
+
+public:
+    /**
+     * Turns NUMA placement on; returns false on single-node machines
+     */
+    static bool enable()
+    {
+        Numa &numa = get();
+        numa.active = (numa.numNodes > 1);
+        return numa.active;
+    }
+
+    static bool enabled() { return get().active; }
+
+    static int nodes() { return get().numNodes; }
+
+    static int cpu_node(int cpu)
+    {
+        Numa &numa = get();
+        if (cpu < 0 || cpu >= (int) numa.cpuNode.size()) return 0;
+        return numa.cpuNode[cpu];
+    }
+
+    static int current_node()
+    {
+        unsigned cpu = 0, node = 0;
+        if (syscall(SYS_getcpu, &cpu, &node, nullptr) != 0) return 0;
+        return (int) node;
+    }
+
+    /**
+     * Records where pinned threads run; must precede any allocation
+     */
+    static void set_thread_cpus(const std::vector<int> &cpus)
+    {
+        get().threadCpu = cpus;
+    }
+
+    static int thread_node(int tid)
+    {
+        Numa &numa = get();
+        if (!numa.threadCpu.empty())
+            return cpu_node(numa.threadCpu[tid % numa.threadCpu.size()]);
+        long ncpus = sysconf(_SC_NPROCESSORS_ONLN);
+        return cpu_node(tid % (ncpus > 0 ? ncpus : 1));
+    }
+
+    /**
+     * Prefers 'node' for the pages of [ptr, ptr + size); a no-op on failure
+     */
+    static void bind(void *ptr, size_t size, int node)
+    {
+        if (!enabled() || node < 0 || node >= MAX_NODES) return;
+        unsigned long mask[MAX_NODES / (8 * sizeof(unsigned long))];
+        memset(mask, 0, sizeof(mask));
+        mask[node / (8 * sizeof(unsigned long))] = 1UL << (node % (8 * sizeof(unsigned long)));
+        syscall(SYS_mbind, ptr, size, MPOL_PREFERRED_, mask, (unsigned long) MAX_NODES, 0);
+    }
+
+    static void *alloc_onnode(size_t size, int node)
+    {
+        if (!enabled()) return aligned_alloc(128, (size + 127) & ~(size_t) 127);
+        void *ptr = mmap(nullptr, pageRound(size), PROT_READ | PROT_WRITE,
+                        MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (ptr == MAP_FAILED) return nullptr;
+        bind(ptr, pageRound(size), node);
+        return ptr;
+    }
+
+    static void free_onnode(void *ptr, size_t size)
+    {
+        if (ptr == nullptr) return;
+        if (!enabled()) {
+            free(ptr);
+            return;
+        }
+        munmap(ptr, pageRound(size));
+    }
+
+    /**
+     * Allocates 'count' per-thread entries of 'elemSize' bytes and places
+     * each page on the node of the first thread whose entry it holds.
+     */
+    static void *alloc_per_thread(size_t elemSize, int count)
+    {
+        size_t size = elemSize * count;
+        void *ptr = alloc_onnode(size, -1);
+        if (ptr == nullptr || !enabled()) return ptr;
+        size_t start = 0;
+        int startNode = thread_node(0);
+        for (size_t off = PAGE; off <= pageRound(size); off += PAGE) {
+            int node = (off < size) ? thread_node(off / elemSize) : -1;
+            if (node == startNode) continue;
+            bind((char *) ptr + start, off - start, startNode);
+            start = off;
+            startNode = node;
+        }
+        return ptr;
+    }
+
+    static void free_per_thread(void *ptr, size_t elemSize, int count)
+    {
+        free_onnode(ptr, elemSize * count);
+    }
+};
+
+#endif /* _NUMA_H_ */
@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2024-2025, Md Amit Hasan Arovi, Ruslan Nikolaev
+ * All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#ifndef _OPEN_LOOP_H_
+#define _OPEN_LOOP_H_
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <thread>
+#include "LatencyHistogram.hpp"
+
+/*
+ * Open-loop pacing: each thread issues operations at the times of an
+ * arrival schedule instead of as fast as it can.
+ *
+ * The schedule is fixed in advance (constant gaps, or exponential gaps
+ * for Poisson arrivals) and does not move when an operation runs late.
+ * A thread that falls behind issues the overdue operations back to back,
+ * and their latency is taken from the intended start, so the time spent
+ * waiting behind a slow operation is counted instead of being omitted
+ * (coordinated omission). Times are in LatencyHistogram ticks.
+ */
+class OpenLoop {
+public:
+    enum Arrivals {
+        ARRIVALS_POISSON = 0,
+        ARRIVALS_CONSTANT = 1
+    };
+
+    static const char *name(int arrivals)
+    {
+        return (arrivals == ARRIVALS_CONSTANT) ? "constant" : "poisson";
+    }
+
+private:
+    // Sleep instead of spinning when the next arrival is further away
+    static const uint64_t SLEEP_NS = 200000;
+
+    std::mt19937_64 gen;
+    double meanTicks;
+    double ticksPerNs;
+    int arrivals;
+    uint64_t due = 0;
+    long long behind = 0;
+
+    inline uint64_t gap()
+    {
+        if (arrivals == ARRIVALS_CONSTANT) return (uint64_t) meanTicks;
+        // Exponential with the given mean; 53 random bits, never log(0)
+        const double u = (gen() >> 11) * (1.0 / 9007199254740992.0);
+        return (uint64_t) (-std::log(1.0 - u) * meanTicks);
+    }
+
+public:
+    /**
+     * 'opsPerSec' is this thread's share of the offered load; 'tpn' is
+     * LatencyHistogram::ticksPerNs(), measured before the threads start
+     */
+    OpenLoop(double opsPerSec, int kind, double tpn, uint64_t seed)
+        : gen(seed), meanTicks(tpn * 1e9 / opsPerSec), ticksPerNs(tpn), arrivals(kind) { }
+
+    // The schedule starts now
+    void start() { due = LatencyHistogram::now(); }
+
+    /**
+     * Waits for the next arrival and returns its intended start, or 0 if
+     * 'quit' was raised while waiting
+     */
+    inline uint64_t next(const std::atomic<bool> &quit)
+    {
+        due += gap();
+        uint64_t now = LatencyHistogram::now();
+        if (now >= due) {
+            behind++;
+            return due;
+        }
+        const uint64_t sleepTicks = (uint64_t) (SLEEP_NS * ticksPerNs);
+        if (due - now > sleepTicks) {
+            std::this_thread::sleep_for(std::chrono::nanoseconds((uint64_t) ((due - now - sleepTicks) / ticksPerNs)));
+        }
+        while (LatencyHistogram::now() < due) {
+            if (quit.load(std::memory_order_relaxed)) return 0;
+        }
+        return due;
+    }
+
+    /**
+     * Operations that were already overdue when their turn came
+     */
+    long long late() const { return behind; }
+};
+
+#endif /* _OPEN_LOOP_H_ */
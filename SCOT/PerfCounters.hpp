@@ -0,0 +1,201 @@
+/*
+ * Copyright (c) 2024-2025, Md Amit Hasan Arovi, Ruslan Nikolaev
+ * All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#ifndef _PERF_COUNTERS_H_
+#define _PERF_COUNTERS_H_
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+/*
+ * Per-thread hardware counters via perf_event_open(2).
+ *
+ * Counters measure the calling thread only (user space). If the kernel
+ * refuses an event (no PMU, perf_event_paranoid, containers), that event
+ * simply reads as unavailable and the benchmark carries on. When more
+ * events are open than the PMU has counters, the kernel multiplexes them
+ * and read() scales the value by the fraction of time it was counted.
+ *
+ * MACHINE_CLEARS counts memory-ordering machine clears, a raw event that
+ * only exists on Intel cores (event 0xC3, umask 0x02).
+ */
+class PerfCounters {
+public:
+    enum Event {
+        DTLB_LOAD_MISSES = 0,
+        DTLB_LOADS = 1,
+        CYCLES = 2,
+        INSTRUCTIONS = 3,
+        LLC_MISSES = 4,
+        BRANCH_MISSES = 5,
+        MACHINE_CLEARS = 6,
+        NUM_EVENTS = 7
+    };
+
+    static const unsigned DTLB_EVENTS = (1U << DTLB_LOAD_MISSES) | (1U << DTLB_LOADS);
+    static const unsigned ALL_EVENTS = (1U << NUM_EVENTS) - 1;
+
+private:
+    int fds[NUM_EVENTS];
+
+    static bool isIntel()
+    {
+        // Initialized once even if several threads open counters at the same time
+        static const bool intel = [] {
+            bool found = false;
+            FILE *f = fopen("/proc/cpuinfo", "r");
+            char line[256];
+            while (f != nullptr && fgets(line, sizeof(line), f) != nullptr) {
+                if (strncmp(line, "vendor_id", 9) == 0) {
+                    found = (strstr(line, "GenuineIntel") != nullptr);
+                    break;
+                }
+            }
+            if (f != nullptr) fclose(f);
+            return found;
+        }();
+        return intel;
+    }
+
+    // Returns false if the event does not exist on this machine
+    static bool eventConfig(int ev, struct perf_event_attr *attr)
+    {
+        const uint64_t dtlb_read = PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8);
+        attr->type = PERF_TYPE_HW_CACHE;
+        switch (ev) {
+        case DTLB_LOAD_MISSES:
+            attr->config = dtlb_read | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+            break;
+        case DTLB_LOADS:
+            attr->config = dtlb_read | (PERF_COUNT_HW_CACHE_RESULT_ACCESS << 16);
+            break;
+        case CYCLES:
+            attr->type = PERF_TYPE_HARDWARE;
+            attr->config = PERF_COUNT_HW_CPU_CYCLES;
+            break;
+        case INSTRUCTIONS:
+            attr->type = PERF_TYPE_HARDWARE;
+            attr->config = PERF_COUNT_HW_INSTRUCTIONS;
+            break;
+        case LLC_MISSES:
+            attr->config = PERF_COUNT_HW_CACHE_LL | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                        (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+            break;
+        case BRANCH_MISSES:
+            attr->type = PERF_TYPE_HARDWARE;
+            attr->config = PERF_COUNT_HW_BRANCH_MISSES;
+            break;
+        case MACHINE_CLEARS:
+            if (!isIntel()) return false;
+            attr->type = PERF_TYPE_RAW;
+            attr->config = 0x02C3;
+            break;
+        }
+        return true;
+    }
+
+public:
+    /**
+     * Opens the events in 'mask' (bit i for Event i)
+     */
+    PerfCounters(unsigned mask = ALL_EVENTS)
+    {
+        for (int ev = 0; ev < NUM_EVENTS; ev++) {
+            fds[ev] = -1;
+            if (!(mask & (1U << ev))) continue;
+            struct perf_event_attr attr;
+            memset(&attr, 0, sizeof(attr));
+            attr.size = sizeof(attr);
+            attr.disabled = 1;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+            if (!eventConfig(ev, &attr)) continue;
+            fds[ev] = (int) syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+        }
+    }
+
+    ~PerfCounters()
+    {
+        for (int ev = 0; ev < NUM_EVENTS; ev++) {
+            if (fds[ev] >= 0) close(fds[ev]);
+        }
+    }
+
+    inline bool available(int ev) const { return fds[ev] >= 0; }
+
+    inline void start()
+    {
+        for (int ev = 0; ev < NUM_EVENTS; ev++) {
+            if (fds[ev] < 0) continue;
+            ioctl(fds[ev], PERF_EVENT_IOC_RESET, 0);
+            ioctl(fds[ev], PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+
+    inline void stop()
+    {
+        for (int ev = 0; ev < NUM_EVENTS; ev++) {
+            if (fds[ev] >= 0) ioctl(fds[ev], PERF_EVENT_IOC_DISABLE, 0);
+        }
+    }
+
+    /**
+     * Returns the counter value, or -1 if the event is unavailable or was
+     * never scheduled on the PMU
+     */
+    long long read(int ev) const
+    {
+        uint64_t value[3]; // value, time enabled, time running
+        if (fds[ev] < 0 || ::read(fds[ev], value, sizeof(value)) != sizeof(value))
+            return -1;
+        if (value[2] == 0) return -1;
+        if (value[2] < value[1])
+            return (long long) ((double) value[0] * value[1] / value[2]);
+        return (long long) value[0];
+    }
+
+    static const char *name(int ev)
+    {
+        static const char *names[NUM_EVENTS] = {
+            "dTLB_load_misses",
+            "dTLB_loads",
+            "cycles",
+            "instructions",
+            "LLC_misses",
+            "branch_misses",
+            "machine_clears_mo"
+        };
+        return names[ev];
+    }
+};
+
+#endif /* _PERF_COUNTERS_H_ */
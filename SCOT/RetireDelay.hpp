@@ -0,0 +1,200 @@
+/*
+ * Copyright (c) 2024-2025, Md Amit Hasan Arovi, Ruslan Nikolaev
+ * All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#ifndef _RETIRE_DELAY_H_
+#define _RETIRE_DELAY_H_
+
+#include <atomic>
+#include <cstdint>
+#include "LatencyHistogram.hpp"
+
+/*
+ * How long retired nodes wait before they are freed (make bench_delay).
+ *
+ * Built with SCOT_RETIRE_DELAY, every node carries a RetireStamp. The
+ * schemes stamp a node in retire() with the time, the retiring thread's
+ * operation count and the number of scans of its retired list so far;
+ * when they free the node, the three differences go into per-thread
+ * histograms: the delay in nanoseconds, in operations of the retiring
+ * thread, and the scans the node survived. HP, HPO, HE, IBR and EBR scan
+ * their retired lists; Hyaline frees a batch when its last reference is
+ * dropped, so it reports no scans. Without the flag every hook is empty
+ * and the nodes keep their size.
+ */
+struct RetireStamp {
+    uint64_t ticks;     // LatencyHistogram::now() at retire()
+    uint64_t ops;       // operations of the retiring thread at retire()
+    uint32_t scans;     // scans of the retiring thread before retire()
+    uint32_t tid;       // the retiring thread
+};
+
+class RetireDelay {
+public:
+    enum Kind {
+        DELAY_NS = 0,
+        DELAY_OPS = 1,
+        DELAY_SCANS = 2,
+        NUM_KINDS = 3
+    };
+
+private:
+    struct Slot {
+        // Read by whichever thread frees a Hyaline node of this thread
+        std::atomic<uint64_t> ops;
+        std::atomic<uint32_t> scans;
+        LatencyHistogram hist[NUM_KINDS];
+        char pad[128];
+    };
+
+    Slot *slots = nullptr;
+    int numSlots = 0;
+
+    static RetireDelay &get() {
+        static RetireDelay instance;
+        return instance;
+    }
+
+    ~RetireDelay() { delete[] slots; }
+
+    static inline Slot *slot(uint32_t tid) {
+        RetireDelay &d = get();
+        return (tid < (uint32_t) d.numSlots) ? &d.slots[tid] : nullptr;
+    }
+
+    // The thread on whose behalf a Hyaline free callback runs
+    static int &current() {
+        static thread_local int tid = 0;
+        return tid;
+    }
+
+public:
+    static constexpr bool enabled() {
+#ifdef SCOT_RETIRE_DELAY
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    /**
+     * Clears the histograms before a run of 'numThreads' threads; the
+     * operation and scan counters keep counting
+     */
+    static void start(int numThreads) {
+        if (!enabled()) return;
+        RetireDelay &d = get();
+        if (numThreads > d.numSlots) {
+            delete[] d.slots;
+            d.slots = new Slot[numThreads];
+            d.numSlots = numThreads;
+            for (int tid = 0; tid < numThreads; tid++) {
+                d.slots[tid].ops.store(0);
+                d.slots[tid].scans.store(0);
+            }
+        }
+        for (int tid = 0; tid < d.numSlots; tid++) {
+            for (int k = 0; k < NUM_KINDS; k++) d.slots[tid].hist[k].reset();
+        }
+    }
+
+    /**
+     * Adds the histograms of all threads to 'out[NUM_KINDS]'
+     */
+    static void take(LatencyHistogram *out) {
+        RetireDelay &d = get();
+        for (int tid = 0; tid < d.numSlots; tid++) {
+            for (int k = 0; k < NUM_KINDS; k++) out[k].merge(d.slots[tid].hist[k]);
+        }
+    }
+
+    /**
+     * Whether any thread has scanned its retired list
+     */
+    static bool scanned() {
+        RetireDelay &d = get();
+        for (int tid = 0; tid < d.numSlots; tid++) {
+            if (d.slots[tid].scans.load(std::memory_order_relaxed) != 0) return true;
+        }
+        return false;
+    }
+
+    // One operation of the benchmark loop
+    static inline void op(const int tid) {
+#ifdef SCOT_RETIRE_DELAY
+        Slot *s = slot(tid);
+        if (s != nullptr) s->ops.store(s->ops.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+#endif
+    }
+
+    // The start of a scan of the retired list of 'tid'
+    static inline void scan(const int tid) {
+#ifdef SCOT_RETIRE_DELAY
+        Slot *s = slot(tid);
+        if (s != nullptr) s->scans.store(s->scans.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+#endif
+    }
+
+    template<typename N>
+    static inline void retired(N *node, const int tid) {
+#ifdef SCOT_RETIRE_DELAY
+        Slot *s = slot(tid);
+        node->retire_stamp.ticks = LatencyHistogram::now();
+        node->retire_stamp.ops = (s != nullptr) ? s->ops.load(std::memory_order_relaxed) : 0;
+        node->retire_stamp.scans = (s != nullptr) ? s->scans.load(std::memory_order_relaxed) : 0;
+        node->retire_stamp.tid = (uint32_t) tid;
+#endif
+    }
+
+    /**
+     * Called by 'tid' right before it frees 'node'. A node freed during a
+     * scan survived all scans since its retirement but that one.
+     */
+    template<typename N>
+    static inline void freed(const N *node, const int tid) {
+#ifdef SCOT_RETIRE_DELAY
+        const RetireStamp &stamp = node->retire_stamp;
+        Slot *s = slot(tid);
+        Slot *r = slot(stamp.tid);
+        if (s == nullptr || r == nullptr) return;
+        const uint32_t scans = r->scans.load(std::memory_order_relaxed);
+        s->hist[DELAY_NS].record(LatencyHistogram::now() - stamp.ticks);
+        s->hist[DELAY_OPS].record(r->ops.load(std::memory_order_relaxed) - stamp.ops);
+        s->hist[DELAY_SCANS].record((scans > stamp.scans) ? scans - stamp.scans - 1 : 0);
+#endif
+    }
+
+    // Hyaline frees nodes in callbacks that do not know the thread
+    static inline void freeing(const int tid) {
+#ifdef SCOT_RETIRE_DELAY
+        current() = tid;
+#endif
+    }
+
+    template<typename N>
+    static inline void freed(const N *node) { freed(node, current()); }
+};
+
+#endif /* _RETIRE_DELAY_H_ */
@@ -0,0 +1,187 @@
+/*
+ * Copyright (c) 2024-2025, Md Amit Hasan Arovi, Ruslan Nikolaev
+ * All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#ifndef _STALL_H_
+#define _STALL_H_
+
+#include <atomic>
+#include <chrono>
+#include <sched.h>
+#include <thread>
+
+/*
+ * Stalls designated threads in the middle of an operation, to show how
+ * each scheme copes with a preempted or delayed reader.
+ *
+ * Threads 0..threads()-1 are the stalled ones. Every period, the benchmark
+ * arms their slots; the next time such a thread reaches a stall point it
+ * sleeps for the configured duration. The stall points sit where a thread
+ * holds its reservation: right after start_op() in EBR, IBR and Hyaline,
+ * and right after a pointer is published in HP, HPO and HE protect().
+ *
+ * The same points can inject sched_yield() every N-th time a thread
+ * passes them during the measured phase, which gives the scheduler a
+ * chance to switch threads mid-operation when there are more threads
+ * than CPUs. Without --stall and --yield the check is one load of a null
+ * pointer.
+ */
+class Stall {
+private:
+    // Slots cover every thread the schemes support (HP_MAX_THREADS)
+    static const int MAX_THREADS = 384;
+
+    struct Slot {
+        std::atomic<bool> armed;
+        int calls;              // stall points passed since the last yield
+        long long yields;
+        char pad[128 - sizeof(std::atomic<bool>) - sizeof(int) - sizeof(long long)];
+    };
+
+    Slot *slots = nullptr;
+    int numStalled = 0;
+    int periodMs = 0;
+    int durationMs = 0;
+    int yieldEvery = 0;
+    std::atomic<bool> yielding = { false };
+    std::atomic<long long> stalls = { 0 };
+
+    static Stall &get() {
+        static Stall instance;
+        return instance;
+    }
+
+    static Slot *active() {
+        return get().slots;
+    }
+
+    static void allocate()
+    {
+        Stall &stall = get();
+        if (stall.slots != nullptr) return;
+        stall.slots = new Slot[MAX_THREADS];
+        for (int i = 0; i < MAX_THREADS; i++) {
+            stall.slots[i].armed.store(false);
+            stall.slots[i].calls = 0;
+            stall.slots[i].yields = 0;
+        }
+    }
+
+    static void hit(Slot *slot)
+    {
+        Stall &stall = get();
+        if (slot->armed.load(std::memory_order_relaxed)) {
+            slot->armed.store(false, std::memory_order_relaxed);
+            stall.stalls.fetch_add(1, std::memory_order_relaxed);
+            std::this_thread::sleep_for(std::chrono::milliseconds(stall.durationMs));
+        }
+        if (stall.yieldEvery != 0 && ++slot->calls >= stall.yieldEvery &&
+                stall.yielding.load(std::memory_order_relaxed)) {
+            slot->calls = 0;
+            slot->yields++;
+            sched_yield();
+        }
+    }
+
+public:
+    /**
+     * Stalls 'threads' threads for 'duration' ms once every 'period' ms
+     */
+    static void configure(int threads, int period, int duration)
+    {
+        Stall &stall = get();
+        stall.numStalled = threads < MAX_THREADS ? threads : MAX_THREADS;
+        stall.periodMs = period;
+        stall.durationMs = duration;
+        allocate();
+    }
+
+    /**
+     * Yields at every 'every'-th stall point while yielding is on
+     */
+    static void configure_yield(int every)
+    {
+        get().yieldEvery = every;
+        allocate();
+    }
+
+    static bool enabled() { return get().numStalled > 0; }
+
+    static bool yield_enabled() { return get().yieldEvery > 0; }
+
+    static int yield_every() { return get().yieldEvery; }
+
+    /**
+     * Turns yield injection on for the measured phase and off afterwards
+     */
+    static void set_yielding(bool on) { get().yielding.store(on); }
+
+    static int threads() { return get().numStalled; }
+
+    static int period() { return get().periodMs; }
+
+    static int duration() { return get().durationMs; }
+
+    static inline void point(const int tid)
+    {
+        Slot *s = active();
+        if (s != nullptr && tid < MAX_THREADS) hit(&s[tid]);
+    }
+
+    /**
+     * Arms (or, with 'on' = false, disarms) the first 'count' stalled threads
+     */
+    static void arm(int count, bool on = true)
+    {
+        Stall &stall = get();
+        for (int i = 0; i < count && i < stall.numStalled; i++)
+            stall.slots[i].armed.store(on, std::memory_order_relaxed);
+    }
+
+    /**
+     * Stalls since the last call
+     */
+    static long long take_count()
+    {
+        return get().stalls.exchange(0);
+    }
+
+    /**
+     * Injected yields since the last call; only when no thread is running
+     */
+    static long long take_yields()
+    {
+        Slot *s = active();
+        long long total = 0;
+        for (int i = 0; s != nullptr && i < MAX_THREADS; i++) {
+            total += s[i].yields;
+            s[i].yields = 0;
+            s[i].calls = 0;
+        }
+        return total;
+    }
+};
+
+#endif /* _STALL_H_ */
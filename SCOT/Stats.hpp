@@ -0,0 +1,190 @@
+/*
+ * Copyright (c) 2024-2025, Md Amit Hasan Arovi, Ruslan Nikolaev
+ * All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#ifndef _STATS_H_
+#define _STATS_H_
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+/*
+ * Statistics over the per-run throughput of --ci.
+ *
+ * Runs are treated as independent samples. The confidence interval of
+ * the mean uses Student's t distribution, and two benchmarks are compared
+ * with Welch's t-test, which does not assume equal variances. Quartiles
+ * interpolate linearly between the sorted samples, and outliers are the
+ * samples more than 1.5 IQR outside the quartiles (Tukey's fences).
+ */
+class Stats {
+public:
+    struct Summary {
+        int n;
+        double mean, sd;
+        double ci;                  // half-width of the 95% confidence interval
+        double q1, median, q3;
+        int outliers;
+    };
+
+    struct Test {
+        double t, df;
+        double p;                   // two-sided
+    };
+
+    static double mean(const std::vector<long long> &x)
+    {
+        double sum = 0;
+        for (long long v : x) sum += v;
+        return x.empty() ? 0 : sum / x.size();
+    }
+
+    static double variance(const std::vector<long long> &x)
+    {
+        if (x.size() < 2) return 0;
+        const double m = mean(x);
+        double sum = 0;
+        for (long long v : x) sum += (v - m) * (v - m);
+        return sum / (x.size() - 1);
+    }
+
+    // Quantile 'q' in [0,1] of sorted samples
+    static double quantile(const std::vector<long long> &sorted, double q)
+    {
+        if (sorted.empty()) return 0;
+        const double pos = q * (sorted.size() - 1);
+        const size_t lo = (size_t) pos;
+        const size_t hi = std::min(lo + 1, sorted.size() - 1);
+        return sorted[lo] + (pos - lo) * (sorted[hi] - sorted[lo]);
+    }
+
+    // Half-width of the 95% confidence interval of the mean
+    static double ci95(const std::vector<long long> &x)
+    {
+        if (x.size() < 2) return 0;
+        return tQuantile(0.975, x.size() - 1) * std::sqrt(variance(x) / x.size());
+    }
+
+    static Summary summarize(std::vector<long long> x)
+    {
+        Summary s;
+        std::sort(x.begin(), x.end());
+        s.n = x.size();
+        s.mean = mean(x);
+        s.sd = std::sqrt(variance(x));
+        s.ci = ci95(x);
+        s.q1 = quantile(x, 0.25);
+        s.median = quantile(x, 0.5);
+        s.q3 = quantile(x, 0.75);
+        const double iqr = s.q3 - s.q1;
+        s.outliers = 0;
+        for (long long v : x) {
+            if (v < s.q1 - 1.5 * iqr || v > s.q3 + 1.5 * iqr) s.outliers++;
+        }
+        return s;
+    }
+
+    // Welch's t-test of equal means
+    static Test welch(const std::vector<long long> &a, const std::vector<long long> &b)
+    {
+        Test r = { 0, 0, 1 };
+        if (a.size() < 2 || b.size() < 2) return r;
+        const double va = variance(a) / a.size(), vb = variance(b) / b.size();
+        if (va + vb == 0) {
+            r.p = (mean(a) == mean(b)) ? 1 : 0;
+            return r;
+        }
+        r.t = (mean(a) - mean(b)) / std::sqrt(va + vb);
+        r.df = (va + vb) * (va + vb) / (va * va / (a.size() - 1) + vb * vb / (b.size() - 1));
+        r.p = 2 * (1 - tCdf(std::fabs(r.t), r.df));
+        return r;
+    }
+
+    // CDF of Student's t distribution with 'df' degrees of freedom
+    static double tCdf(double t, double df)
+    {
+        const double tail = 0.5 * incompleteBeta(df / 2, 0.5, df / (df + t * t));
+        return (t >= 0) ? 1 - tail : tail;
+    }
+
+    // Inverse of tCdf() for p in (0.5, 1), by bisection
+    static double tQuantile(double p, double df)
+    {
+        double lo = 0, hi = 1;
+        while (tCdf(hi, df) < p) hi *= 2;
+        for (int i = 0; i < 100; i++) {
+            const double mid = (lo + hi) / 2;
+            if (tCdf(mid, df) < p) lo = mid; else hi = mid;
+        }
+        return (lo + hi) / 2;
+    }
+
+private:
+    // Regularized incomplete beta function I_x(a, b)
+    static double incompleteBeta(double a, double b, double x)
+    {
+        if (x <= 0) return 0;
+        if (x >= 1) return 1;
+        const double front = std::exp(std::lgamma(a + b) - std::lgamma(a) - std::lgamma(b)
+                                      + a * std::log(x) + b * std::log(1 - x));
+        if (x < (a + 1) / (a + b + 2)) return front * betaFraction(a, b, x) / a;
+        return 1 - front * betaFraction(b, a, 1 - x) / b;
+    }
+
+    // Continued fraction of incompleteBeta(), by the modified Lentz method
+    static double betaFraction(double a, double b, double x)
+    {
+        const double TINY = 1e-300, EPS = 1e-14;
+        double c = 1, d = 1 - (a + b) * x / (a + 1);
+        if (std::fabs(d) < TINY) d = TINY;
+        d = 1 / d;
+        double h = d;
+        for (int m = 1; m <= 300; m++) {
+            const int m2 = 2 * m;
+            // Even step
+            double aa = m * (b - m) * x / ((a + m2 - 1) * (a + m2));
+            d = 1 + aa * d;
+            if (std::fabs(d) < TINY) d = TINY;
+            c = 1 + aa / c;
+            if (std::fabs(c) < TINY) c = TINY;
+            d = 1 / d;
+            h *= d * c;
+            // Odd step
+            aa = -(a + m) * (a + b + m) * x / ((a + m2) * (a + m2 + 1));
+            d = 1 + aa * d;
+            if (std::fabs(d) < TINY) d = TINY;
+            c = 1 + aa / c;
+            if (std::fabs(c) < TINY) c = TINY;
+            d = 1 / d;
+            const double del = d * c;
+            h *= del;
+            if (std::fabs(del - 1) < EPS) break;
+        }
+        return h;
+    }
+};
+
+#endif /* _STATS_H_ */
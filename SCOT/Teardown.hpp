@@ -0,0 +1,153 @@
+/*
+ * Copyright (c) 2024-2025, Md Amit Hasan Arovi, Ruslan Nikolaev
+ * All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#ifndef _TEARDOWN_H_
+#define _TEARDOWN_H_
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "NodeArena.hpp"
+
+/*
+ * Bulk teardown of a data structure between runs.
+ *
+ * The data structures' destroy() frees the nodes that are still reachable
+ * and the nodes retired to the reclamation scheme with several threads.
+ * It needs quiescence: no operation may be in progress, so the nodes are
+ * freed with a plain 'delete' and without any protection. A tree is split
+ * into subtrees breadth-first, and threads take the subtrees from a shared
+ * counter, which balances unbalanced trees as well. A list has to be
+ * walked in order, so one thread collects its nodes and all threads free
+ * them. Retired lists are freed by their tids modulo the thread count.
+ */
+class Teardown {
+public:
+    enum {
+        // Subtrees per thread, so that a thread with a large one is not the last to finish
+        SUBTREES_PER_THREAD = 16,
+        // Fewer nodes than this are freed by the calling thread
+        PARALLEL_NODES = 65536
+    };
+
+    /**
+     * Runs fn(t) for t in [0, numThreads), on new threads bound to node
+     * arena t, or on the calling thread if numThreads is 1
+     */
+    template<typename F>
+    static void parallel(int numThreads, F fn)
+    {
+        if (numThreads <= 1) {
+            fn(0);
+            return;
+        }
+        std::vector<std::thread> threads;
+        for (int t = 0; t < numThreads; t++) {
+            threads.emplace_back([&fn, t] {
+                NodeArena::bind(t);
+                fn(t);
+                NodeArena::unbind();
+            });
+        }
+        for (auto &thread : threads) thread.join();
+    }
+
+    /**
+     * Frees a linked list starting at 'head'; next(node) returns the
+     * unmarked successor of a node
+     */
+    template<typename N, typename Next>
+    static void freeList(N *head, Next next, int numThreads)
+    {
+        std::vector<N*> nodes;
+        for (N *node = head; node != nullptr; node = next(node)) nodes.push_back(node);
+        if (nodes.size() < PARALLEL_NODES) numThreads = 1;
+        parallel(numThreads, [&nodes, numThreads](int t) {
+            const size_t chunk = (nodes.size() + numThreads - 1) / numThreads;
+            const size_t end = std::min(nodes.size(), (t + 1) * chunk);
+            for (size_t i = t * chunk; i < end; i++) delete nodes[i];
+        });
+    }
+
+    /**
+     * Frees a binary tree starting at 'root'; children(node, c) stores the
+     * unmarked children of a node in c[0] and c[1] (nullptr for a leaf)
+     */
+    template<typename N, typename Children>
+    static void freeTree(N *root, Children children, int numThreads)
+    {
+        if (root == nullptr) return;
+        // Breadth-first from the root until there are enough subtrees and
+        // PARALLEL_NODES nodes are freed; a smaller tree is freed entirely
+        std::vector<N*> roots = { root };
+        size_t first = 0;
+        const size_t target = (numThreads > 1) ? (size_t) numThreads * SUBTREES_PER_THREAD : 1;
+        while (first < roots.size() &&
+               (roots.size() - first < target || (numThreads > 1 && first < PARALLEL_NODES))) {
+            N *node = roots[first++];
+            N *c[2];
+            children(node, c);
+            if (c[0] != nullptr) roots.push_back(c[0]);
+            if (c[1] != nullptr) roots.push_back(c[1]);
+            delete node;
+        }
+        if (first == roots.size()) return;
+        std::atomic<size_t> nextRoot { first };
+        parallel(numThreads, [&roots, &nextRoot, &children](int t) {
+            std::vector<N*> stack;
+            for (size_t i; (i = nextRoot.fetch_add(1)) < roots.size(); ) {
+                stack.push_back(roots[i]);
+                while (!stack.empty()) {
+                    N *node = stack.back();
+                    stack.pop_back();
+                    N *c[2];
+                    children(node, c);
+                    if (c[0] != nullptr) stack.push_back(c[0]);
+                    if (c[1] != nullptr) stack.push_back(c[1]);
+                    delete node;
+                }
+            }
+        });
+    }
+
+    /**
+     * Frees the nodes retired to 'smr' by all of its 'maxThreads' threads
+     */
+    template<typename SMR>
+    static void freeRetired(SMR &smr, int maxThreads, int numThreads)
+    {
+        long long retired = 0;
+        for (int tid = 0; tid < maxThreads; tid++) retired += smr.cur_space(tid);
+        numThreads = std::min(numThreads, maxThreads);
+        if (retired < PARALLEL_NODES) numThreads = 1;
+        parallel(numThreads, [&smr, maxThreads, numThreads](int t) {
+            for (int tid = t; tid < maxThreads; tid += numThreads) smr.clear_retired(tid);
+        });
+    }
+};
+
+#endif /* _TEARDOWN_H_ */
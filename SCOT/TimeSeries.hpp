@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) 2024-2025, Md Amit Hasan Arovi, Ruslan Nikolaev
+ * All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#ifndef _TIME_SERIES_H_
+#define _TIME_SERIES_H_
+
+#include <atomic>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+/*
+ * Samples taken every few milliseconds during the measured phase of a run:
+ * operations completed so far, nodes retired but not yet freed, and the
+ * resident set size of the process.
+ *
+ * Workers publish their operation count to a padded Progress slot (a
+ * relaxed store every PUBLISH_MASK + 1 operations), so the sampler never
+ * touches their private state. Samples stay in memory until the run is
+ * over and are then appended to a CSV file, one row per sample.
+ */
+class TimeSeries {
+public:
+    static const long long PUBLISH_MASK = 63;
+
+    // One per thread; the padding keeps other threads' slots off the line
+    struct Progress {
+        std::atomic<long long> ops;
+        char pad[128 - sizeof(std::atomic<long long>)];
+
+        Progress() : ops(0) { }
+    };
+
+private:
+    struct Sample {
+        long long timeUs;
+        long long ops;
+        long long unreclaimed;
+        long long rss;
+    };
+
+    std::vector<Sample> samples;
+
+public:
+    void clear() { samples.clear(); }
+
+    void record(long long timeUs, long long ops, long long unreclaimed, long long rss)
+    {
+        samples.push_back({ timeUs, ops, unreclaimed, rss });
+    }
+
+    /**
+     * Truncates 'path' and writes the CSV header; false if it cannot be created
+     */
+    static bool create(const std::string &path)
+    {
+        FILE *f = fopen(path.c_str(), "w");
+        if (f == nullptr) return false;
+        fprintf(f, "benchmark,threads,run,time_ms,ops,ops_per_sec,unreclaimed_nodes,rss_bytes\n");
+        fclose(f);
+        return true;
+    }
+
+    /**
+     * Appends the samples of one run; the throughput column covers the
+     * interval since the previous sample
+     */
+    bool append(const std::string &path, const std::string &benchmark, int numThreads, int run) const
+    {
+        FILE *f = fopen(path.c_str(), "a");
+        if (f == nullptr) return false;
+        long long prevUs = 0, prevOps = 0;
+        for (const Sample &s : samples) {
+            long long rate = (s.timeUs == prevUs) ? 0 : (s.ops - prevOps) * 1000000 / (s.timeUs - prevUs);
+            fprintf(f, "%s,%d,%d,%.3f,%lld,%lld,%lld,%lld\n", benchmark.c_str(), numThreads, run,
+                    s.timeUs / 1000.0, s.ops, rate, s.unreclaimed, s.rss);
+            prevUs = s.timeUs;
+            prevOps = s.ops;
+        }
+        fclose(f);
+        return true;
+    }
+};
+
+#endif /* _TIME_SERIES_H_ */
@@ -0,0 +1,300 @@
+/*
+ * Copyright (c) 2024-2025, Md Amit Hasan Arovi, Ruslan Nikolaev
+ * All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#ifndef _TOPOLOGY_H_
+#define _TOPOLOGY_H_
+
+#include <algorithm>
+#include <cstdio>
+#include <pthread.h>
+#include <sched.h>
+#include <string>
+#include <vector>
+#include "Numa.hpp"
+
+/*
+ * CPU topology from /sys/devices/system/cpu and thread pinning.
+ *
+ * A policy turns the online CPUs into a placement: benchmark thread 'tid'
+ * runs on placement[tid % size]. The placement is also handed to Numa,
+ * so per-thread state lands on the node its thread actually runs on.
+ *
+ *   compact   fill one socket at a time, one hardware thread per core
+ *             before the SMT siblings
+ *   scatter   alternate between sockets, otherwise as compact
+ *   smt       fill one socket at a time, both siblings of a core together
+ *   <list>    the given CPUs in order, e.g. "0-7,16-23"
+ *
+ * sweep() derives the thread counts of a scaling run from the same
+ * topology: one thread, the hardware threads of one core, the cores of
+ * one socket, all cores, all hardware threads, and multiples of the
+ * latter. Each point carries the policy that gives it its meaning.
+ */
+class Topology {
+public:
+    enum Policy {
+        PIN_NONE = 0,
+        PIN_COMPACT = 1,
+        PIN_SCATTER = 2,
+        PIN_SMT = 3,
+        PIN_LIST = 4
+    };
+
+    struct SweepPoint {
+        int threads;
+        std::string label;      // e.g. "socket", or "socket+cores" if they coincide
+        const char *pin;        // policy for configure()
+    };
+
+private:
+    struct Cpu {
+        int id;
+        int socket;
+        int core;
+    };
+
+    std::vector<Cpu> cpus;
+    std::vector<int> placement;
+    int policy = PIN_NONE;
+
+    static Topology &get() {
+        static Topology instance;
+        return instance;
+    }
+
+    static int readInt(const char *path, int fallback)
+    {
+        FILE *f = fopen(path, "r");
+        if (f == nullptr) return fallback;
+        int value;
+        if (fscanf(f, "%d", &value) != 1) value = fallback;
+        fclose(f);
+        return value;
+    }
+
+    Topology()
+    {
+        std::vector<int> online;
+        FILE *f = fopen("/sys/devices/system/cpu/online", "r");
+        char buf[4096];
+        if (f != nullptr && fgets(buf, sizeof(buf), f) != nullptr) parseList(buf, online);
+        if (f != nullptr) fclose(f);
+        if (online.empty()) {
+            long ncpus = sysconf(_SC_NPROCESSORS_ONLN);
+            for (int cpu = 0; cpu < (ncpus > 0 ? ncpus : 1); cpu++) online.push_back(cpu);
+        }
+        for (int cpu : online) {
+            char path[128];
+            snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/topology/physical_package_id", cpu);
+            int socket = readInt(path, 0);
+            snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/topology/core_id", cpu);
+            int core = readInt(path, cpu);
+            cpus.push_back({cpu, socket, core});
+        }
+        std::sort(cpus.begin(), cpus.end(), [](const Cpu &a, const Cpu &b) {
+            if (a.socket != b.socket) return a.socket < b.socket;
+            if (a.core != b.core) return a.core < b.core;
+            return a.id < b.id;
+        });
+    }
+
+    // One socket's CPUs: cores in order, or SMT level by SMT level
+    std::vector<int> socketOrder(int socket, bool siblingsTogether) const
+    {
+        std::vector<int> order;
+        if (siblingsTogether) {
+            for (const Cpu &c : cpus)
+                if (c.socket == socket) order.push_back(c.id);
+            return order;
+        }
+        for (int level = 0; ; level++) {
+            size_t before = order.size();
+            int prevCore = -1, sibling = 0;
+            for (const Cpu &c : cpus) {
+                if (c.socket != socket) continue;
+                sibling = (c.core == prevCore) ? sibling + 1 : 0;
+                prevCore = c.core;
+                if (sibling == level) order.push_back(c.id);
+            }
+            if (order.size() == before) return order;
+        }
+    }
+
+public:
+    /**
+     * Parses a cpulist such as "0-3,8,10-11"; returns false if malformed
+     */
+    static bool parseList(const char *str, std::vector<int> &out)
+    {
+        const char *p = str;
+        while (*p != '\0' && *p != '\n') {
+            char *end;
+            long lo = strtol(p, &end, 10), hi = lo;
+            if (end == p || lo < 0) return false;
+            p = end;
+            if (*p == '-') {
+                hi = strtol(p + 1, &end, 10);
+                if (end == p + 1 || hi < lo) return false;
+                p = end;
+            }
+            for (long cpu = lo; cpu <= hi; cpu++) out.push_back((int) cpu);
+            if (*p == ',') p++;
+            else if (*p != '\0' && *p != '\n') return false;
+        }
+        return !out.empty();
+    }
+
+    /**
+     * Sets the policy from "compact", "scatter", "smt" or a CPU list
+     */
+    static bool configure(const std::string &spec)
+    {
+        Topology &topo = get();
+        std::vector<int> sockets;
+        for (const Cpu &c : topo.cpus) {
+            if (sockets.empty() || sockets.back() != c.socket) sockets.push_back(c.socket);
+        }
+        topo.placement.clear();
+        if (spec == "compact" || spec == "smt") {
+            topo.policy = (spec == "compact") ? PIN_COMPACT : PIN_SMT;
+            for (int socket : sockets) {
+                std::vector<int> order = topo.socketOrder(socket, topo.policy == PIN_SMT);
+                topo.placement.insert(topo.placement.end(), order.begin(), order.end());
+            }
+        } else if (spec == "scatter") {
+            topo.policy = PIN_SCATTER;
+            std::vector<std::vector<int>> orders;
+            for (int socket : sockets) orders.push_back(topo.socketOrder(socket, false));
+            for (size_t i = 0; topo.placement.size() < topo.cpus.size(); i++) {
+                for (auto &order : orders)
+                    if (i < order.size()) topo.placement.push_back(order[i]);
+            }
+        } else {
+            topo.policy = PIN_LIST;
+            if (!parseList(spec.c_str(), topo.placement)) {
+                topo.policy = PIN_NONE;
+                topo.placement.clear();
+                return false;
+            }
+        }
+        Numa::set_thread_cpus(topo.placement);
+        return true;
+    }
+
+    static int current_policy() { return get().policy; }
+
+    static const char *policy_name()
+    {
+        static const char *names[] = { "none", "compact", "scatter", "smt", "list" };
+        return names[get().policy];
+    }
+
+    static int num_sockets()
+    {
+        Topology &topo = get();
+        return topo.cpus.empty() ? 1 : topo.cpus.back().socket + 1;
+    }
+
+    static int num_cpus() { return (int) get().cpus.size(); }
+
+    /**
+     * Scaling points from the topology, smallest first; 'multiples' adds
+     * that many times all hardware threads (oversubscribed)
+     */
+    static std::vector<SweepPoint> sweep(const std::vector<int> &multiples)
+    {
+        Topology &topo = get();
+        const Cpu &first = topo.cpus.front();
+        int perCore = 0, perSocket = 0, cores = 0;
+        for (size_t i = 0; i < topo.cpus.size(); i++) {
+            const Cpu &c = topo.cpus[i];
+            const bool newCore = (i == 0 || c.socket != topo.cpus[i - 1].socket || c.core != topo.cpus[i - 1].core);
+            if (c.socket == first.socket && c.core == first.core) perCore++;
+            if (!newCore) continue;
+            cores++;
+            if (c.socket == first.socket) perSocket++;
+        }
+        const int all = num_cpus();
+        std::vector<SweepPoint> points = {
+            { 1, "1", "compact" },
+            { perCore, "core", "smt" },
+            { perSocket, "socket", "compact" },
+            { cores, "cores", "scatter" },
+            { all, "smt", "compact" }
+        };
+        for (int m : multiples) points.push_back({ m * all, std::to_string(m) + "x", "compact" });
+        std::stable_sort(points.begin(), points.end(), [](const SweepPoint &a, const SweepPoint &b) {
+            return a.threads < b.threads;
+        });
+        // Points of the same size share the placement of the first one
+        std::vector<SweepPoint> out;
+        for (const SweepPoint &p : points) {
+            if (!out.empty() && out.back().threads == p.threads) out.back().label += "+" + p.label;
+            else out.push_back(p);
+        }
+        return out;
+    }
+
+    /**
+     * The CPU of benchmark thread 'tid', or -1 without pinning
+     */
+    static int cpu_of(int tid)
+    {
+        Topology &topo = get();
+        if (topo.placement.empty()) return -1;
+        return topo.placement[tid % topo.placement.size()];
+    }
+
+    /**
+     * Pins the calling thread to the CPU of 'tid'; a no-op without pinning
+     */
+    static void pin(int tid)
+    {
+        int cpu = cpu_of(tid);
+        if (cpu < 0) return;
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    }
+
+    /**
+     * "cpu@node" for the first 'numThreads' threads, for the results
+     */
+    static std::string describe(int numThreads)
+    {
+        std::string out;
+        for (int tid = 0; tid < numThreads; tid++) {
+            int cpu = cpu_of(tid);
+            if (cpu < 0) return "unpinned";
+            if (tid > 0) out += ",";
+            out += std::to_string(cpu) + "@" + std::to_string(Numa::cpu_node(cpu));
+        }
+        return out;
+    }
+};
+
+#endif /* _TOPOLOGY_H_ */
@@ -0,0 +1,219 @@
+/*
+ * Copyright (c) 2024-2025, Md Amit Hasan Arovi, Ruslan Nikolaev
+ * All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#ifndef _TRACE_H_
+#define _TRACE_H_
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/*
+ * Binary operation traces, one stream per thread.
+ *
+ * Layout (little endian):
+ *   Header                  magic "SCOTTRC1", thread count, key bits,
+ *                           number of elements the keys index
+ *   uint64_t count[threads] entries in each stream
+ *   uint32_t entries[]      the streams back to back
+ *
+ * An entry packs the operation in the top 2 bits (0 = search, 1 = insert,
+ * 2 = remove) and the key index in the low KEY_BITS bits. The file is
+ * mapped read-only and validated once; replaying an operation is then a
+ * load from a sequential stream, with a prefetch a few lines ahead.
+ * Thread 'tid' replays stream tid % threads and wraps around at its end.
+ * Scripts/generate_trace.py writes traces offline.
+ */
+class Trace {
+public:
+    enum Op {
+        OP_SEARCH = 0,
+        OP_INSERT = 1,
+        OP_REMOVE = 2
+    };
+
+    static const uint32_t KEY_BITS = 30;
+    static const uint32_t KEY_MASK = (1U << KEY_BITS) - 1;
+    // Entries a recorded run keeps, split evenly among the threads (256 MB)
+    static const size_t RECORD_ENTRIES = 1UL << 26;
+
+    struct Header {
+        char magic[8];
+        uint32_t threads;
+        uint32_t keyBits;
+        uint64_t numElements;
+    };
+
+    static inline uint32_t entry(int op, uint64_t key)
+    {
+        return ((uint32_t) op << KEY_BITS) | (uint32_t) key;
+    }
+
+    static inline int op(uint32_t e) { return (int) (e >> KEY_BITS); }
+
+    static inline uint32_t key(uint32_t e) { return e & KEY_MASK; }
+
+    // A thread's position in its stream
+    class Cursor {
+    private:
+        static const size_t PREFETCH_AHEAD = 256; // entries, i.e., 16 lines
+        const uint32_t *begin;
+        const uint32_t *end;
+        const uint32_t *cur;
+
+    public:
+        Cursor(const uint32_t *b, const uint32_t *e) : begin(b), end(e), cur(b) { }
+
+        inline uint32_t next()
+        {
+            if (cur == end) cur = begin;
+            if (((uintptr_t) cur & 63) == 0) __builtin_prefetch(cur + PREFETCH_AHEAD);
+            return *cur++;
+        }
+    };
+
+private:
+    static const char *magic() { return "SCOTTRC1"; }
+
+    void *map = nullptr;
+    size_t mapSize = 0;
+    const Header *header = nullptr;
+    std::vector<const uint32_t *> streams; // threads + 1 boundaries
+
+    static Trace &get() {
+        static Trace instance;
+        return instance;
+    }
+
+    ~Trace()
+    {
+        if (map != nullptr) munmap(map, mapSize);
+    }
+
+public:
+    /**
+     * Maps 'path' for replay; prints the problem and returns false if the
+     * file is not a valid trace
+     */
+    static bool open(const std::string &path)
+    {
+        Trace &trace = get();
+        int fd = ::open(path.c_str(), O_RDONLY);
+        struct stat st;
+        if (fd < 0 || fstat(fd, &st) != 0) {
+            std::cerr << "Cannot open trace " << path << "\n";
+            if (fd >= 0) close(fd);
+            return false;
+        }
+        trace.mapSize = st.st_size;
+        trace.map = (trace.mapSize < sizeof(Header)) ? MAP_FAILED :
+                    mmap(nullptr, trace.mapSize, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (trace.map == MAP_FAILED) {
+            trace.map = nullptr;
+            std::cerr << "Cannot map trace " << path << "\n";
+            return false;
+        }
+        madvise(trace.map, trace.mapSize, MADV_SEQUENTIAL);
+        const Header *h = static_cast<const Header *>(trace.map);
+        if (memcmp(h->magic, magic(), sizeof(h->magic)) != 0 || h->keyBits != KEY_BITS || h->threads == 0 ||
+                sizeof(Header) + h->threads * sizeof(uint64_t) > trace.mapSize) {
+            std::cerr << path << " is not a trace file\n";
+            return false;
+        }
+        const uint64_t *counts = reinterpret_cast<const uint64_t *>(h + 1);
+        const uint32_t *entries = reinterpret_cast<const uint32_t *>(counts + h->threads);
+        const uint32_t *limit = reinterpret_cast<const uint32_t *>((const char *) trace.map + trace.mapSize);
+        trace.streams.push_back(entries);
+        for (uint32_t t = 0; t < h->threads; t++) {
+            if (counts[t] == 0 || counts[t] > (uint64_t) (limit - trace.streams.back())) {
+                std::cerr << path << ": stream " << t << " is empty or truncated\n";
+                return false;
+            }
+            trace.streams.push_back(trace.streams.back() + counts[t]);
+        }
+        // One pass to catch bad entries; it also faults the file in
+        for (const uint32_t *e = entries; e != trace.streams.back(); e++) {
+            if (op(*e) > OP_REMOVE || key(*e) >= h->numElements) {
+                std::cerr << path << ": bad entry at offset " << ((const char *) e - (const char *) trace.map) << "\n";
+                return false;
+            }
+        }
+        trace.header = h;
+        return true;
+    }
+
+    static bool replaying() { return get().header != nullptr; }
+
+    static int threads() { return get().header->threads; }
+
+    static uint64_t num_elements() { return get().header->numElements; }
+
+    static uint64_t entries()
+    {
+        Trace &trace = get();
+        return trace.streams.back() - trace.streams.front();
+    }
+
+    static Cursor cursor(int tid)
+    {
+        Trace &trace = get();
+        int t = tid % trace.header->threads;
+        return Cursor(trace.streams[t], trace.streams[t + 1]);
+    }
+
+    /**
+     * Writes one stream per thread; false on I/O errors
+     */
+    static bool write(const std::string &path, uint64_t numElements, const std::vector<std::vector<uint32_t>> &data)
+    {
+        FILE *f = fopen(path.c_str(), "wb");
+        if (f == nullptr) return false;
+        Header h;
+        memcpy(h.magic, magic(), sizeof(h.magic));
+        h.threads = (uint32_t) data.size();
+        h.keyBits = KEY_BITS;
+        h.numElements = numElements;
+        bool ok = fwrite(&h, sizeof(h), 1, f) == 1;
+        for (const auto &stream : data) {
+            uint64_t count = stream.size();
+            ok = ok && fwrite(&count, sizeof(count), 1, f) == 1;
+        }
+        for (const auto &stream : data) {
+            ok = ok && fwrite(stream.data(), sizeof(uint32_t), stream.size(), f) == stream.size();
+        }
+        return (fclose(f) == 0) && ok;
+    }
+};
+
+#endif /* _TRACE_H_ */
@@ -27,6 +27,8 @@
 #ifndef _WAIT_FREE_H_
 #define _WAIT_FREE_H_
 
+#include "Numa.hpp"
+
 #define WF_THRESHOLD 32
 
 template<typename T>
@@ -49,7 +51,7 @@ private:
 public:
 
     WaitFree(int _maxThreads=WF_MAX_THREADS) : maxThreads{_maxThreads} {
-        wfc = static_cast<wait_free_controller_t*>(aligned_alloc(128, sizeof(wait_free_controller_t) * WF_MAX_THREADS));
+        wfc = static_cast<wait_free_controller_t*>(Numa::alloc_per_thread(sizeof(wait_free_controller_t), WF_MAX_THREADS));
         for (int it = 0; it < WF_MAX_THREADS; it++) {
             wfc[it].helper_key.store(nullptr, std::memory_order_relaxed);
             wfc[it].helper_tag.store(0, std::memory_order_relaxed);
@@ -59,7 +61,9 @@ public:
         }
     }
 
-    ~WaitFree() {}
+    ~WaitFree() {
+        Numa::free_per_thread(wfc, sizeof(wait_free_controller_t), WF_MAX_THREADS);
+    }
 
     inline size_t request_help(T* key, const int tid)
     {
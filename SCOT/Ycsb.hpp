@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2024-2025, Md Amit Hasan Arovi, Ruslan Nikolaev
+ * All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#ifndef _YCSB_H_
+#define _YCSB_H_
+
+#include "KeyGenerator.hpp"
+
+/*
+ * The YCSB core workloads A-F on top of the sets, whose list nodes and
+ * tree leaves carry a value (see NodeValue in NodeArena.hpp):
+ *
+ *   read     search, which copies the value out of the node
+ *   update   remove + insert of a node with a new value; the old node and
+ *            its value are retired, as in a copy-on-write map
+ *   insert   insert with a new value
+ *   scan     reads of up to MAX_SCAN consecutive keys (the sets have no
+ *            range iteration)
+ *   rmw      read, then update
+ *
+ * An update is not atomic: a concurrent read of the same key can miss it
+ * between the remove and the insert.
+ */
+class Ycsb {
+public:
+    enum Op {
+        READ = 0,
+        UPDATE = 1,
+        INSERT = 2,
+        SCAN = 3,
+        RMW = 4,
+        NUM_OPS = 5
+    };
+
+    static const int MAX_SCAN = 100;
+
+    struct Workload {
+        char name;
+        int percent[NUM_OPS];   // read, update, insert, scan, rmw
+        int dist;               // KeyDistribution::Type
+        double prefill;         // fraction of the keys loaded before the run
+    };
+
+private:
+    const Workload *w;
+    int cumulative[NUM_OPS];
+
+public:
+    /**
+     * Returns the workload 'A'..'F', or nullptr
+     */
+    static const Workload *workload(char name)
+    {
+        static const Workload table[] = {
+            { 'A', { 50, 50, 0, 0, 0 }, KeyDistribution::DIST_ZIPF, 1.0 },
+            { 'B', { 95, 5, 0, 0, 0 }, KeyDistribution::DIST_ZIPF, 1.0 },
+            { 'C', { 100, 0, 0, 0, 0 }, KeyDistribution::DIST_ZIPF, 1.0 },
+            { 'D', { 95, 0, 5, 0, 0 }, KeyDistribution::DIST_LATEST, 0.5 },
+            { 'E', { 0, 0, 5, 95, 0 }, KeyDistribution::DIST_ZIPF, 0.5 },
+            { 'F', { 50, 0, 0, 0, 50 }, KeyDistribution::DIST_ZIPF, 1.0 },
+        };
+        for (const Workload &t : table) {
+            if (t.name == name || t.name == name - 'a' + 'A') return &t;
+        }
+        return nullptr;
+    }
+
+    static const char *name(int op)
+    {
+        static const char *names[NUM_OPS] = { "read", "update", "insert", "scan", "rmw" };
+        return names[op];
+    }
+
+    explicit Ycsb(const Workload *workload) : w(workload)
+    {
+        int sum = 0;
+        for (int op = 0; op < NUM_OPS; op++) {
+            sum += w->percent[op];
+            cumulative[op] = sum;
+        }
+    }
+
+    const Workload &get() const { return *w; }
+
+    // 'p' is uniform in [0, 100)
+    inline int pick(int p) const
+    {
+        int op = 0;
+        while (p >= cumulative[op]) op++;
+        return op;
+    }
+};
+
+#endif /* _YCSB_H_ */
@@ -11,11 +11,130 @@
 #include <thread>
 #include <string>
 #include <regex>
+#include <sstream>
 #include "BenchmarkLists.hpp"
 
+// "2,4" -> { 2, 4 }; false unless every entry is a positive integer
+static bool parseMultiples(const std::string &spec, std::vector<int> &out) {
+    std::stringstream ss(spec);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        try {
+            out.push_back(std::stoi(item));
+            if (out.back() <= 0) return false;
+        } catch (...) {
+            return false;
+        }
+    }
+    return !out.empty();
+}
+
+// An operation mix of --roles and --phases: read, write or churn (50/50
+// insert/remove), grow (inserts), shrink (removes), scan, or R/I/D[/S]
+static bool parseMix(const std::string &name, OpMix &mix) {
+    mix = { 0, 0, 0, 0, name };
+    char end;
+    if (name == "read") {
+        mix.read = 100;
+    } else if (name == "write" || name == "churn") {
+        mix.insert = mix.remove = 50;
+    } else if (name == "grow") {
+        mix.insert = 100;
+    } else if (name == "shrink") {
+        mix.remove = 100;
+    } else if (name == "scan") {
+        mix.scan = 100;
+    } else {
+        int n = sscanf(name.c_str(), "%d/%d/%d/%d%c", &mix.read, &mix.insert, &mix.remove, &mix.scan, &end);
+        if ((n != 3 && n != 4) || mix.read < 0 || mix.insert < 0 || mix.remove < 0 || mix.scan < 0 ||
+                mix.read + mix.insert + mix.remove + mix.scan != 100) return false;
+    }
+    return true;
+}
+
+// "8:write,120:read" -> groups of threads with their own mix
+static bool parseRoles(const std::string &spec, std::vector<ThreadRole> &out) {
+    std::stringstream ss(spec);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        ThreadRole role;
+        const size_t colon = item.find(':');
+        if (colon == std::string::npos || !parseMix(item.substr(colon + 1), role.mix)) return false;
+        try {
+            role.threads = std::stoi(item.substr(0, colon));
+        } catch (...) {
+            return false;
+        }
+        if (role.threads <= 0) return false;
+        out.push_back(role);
+    }
+    return !out.empty();
+}
+
+// "grow:5,churn:10,shrink:until=0" -> mixes that all threads run one after
+// another, each for S seconds or until the structure holds N keys (within S
+// seconds if given, Phase::UNTIL_LIMIT otherwise)
+static bool parsePhases(const std::string &spec, std::vector<Phase> &out) {
+    std::stringstream ss(spec);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        Phase phase;
+        std::stringstream fields(item);
+        std::string field;
+        if (!std::getline(fields, field, ':') || !parseMix(field, phase.mix)) return false;
+        phase.seconds = 0;
+        while (std::getline(fields, field, ':')) {
+            size_t used;
+            try {
+                if (field.compare(0, 6, "until=") == 0 && phase.until < 0) {
+                    phase.until = std::stoll(field.substr(6), &used);
+                    used += 6;
+                    if (phase.until < 0) return false;
+                } else if (phase.seconds == 0) {
+                    phase.seconds = std::stoi(field, &used);
+                    if (phase.seconds <= 0) return false;
+                } else {
+                    return false;
+                }
+            } catch (...) {
+                return false;
+            }
+            if (used != field.size()) return false;
+        }
+        if (phase.seconds == 0) {
+            if (phase.until < 0) return false;
+            phase.seconds = Phase::UNTIL_LIMIT;
+        }
+        out.push_back(phase);
+    }
+    return !out.empty();
+}
+
 int main(int argc, char* argv[]) {
+    // The thread counts of the topology sweep, for the scripts; --list-points adds each point's --pin policy
+    const bool listPoints = (argc == 2 && std::string(argv[1]).compare(0, 13, "--list-points") == 0);
+    if (listPoints || (argc == 2 && std::string(argv[1]).compare(0, 14, "--list-threads") == 0)) {
+        std::string arg = argv[1];
+        const size_t len = listPoints ? 13 : 14;
+        std::vector<int> multiples;
+        if (arg.size() > len && (arg[len] != '=' || !parseMultiples(arg.substr(len + 1), multiples))) {
+            std::cerr << "Invalid multiples in " << arg << std::endl;
+            return 1;
+        }
+        const char *sep = "";
+        for (const Topology::SweepPoint &point : BenchmarkLists::sweepPoints(multiples)) {
+            std::cout << sep << point.threads;
+            if (listPoints) std::cout << ":" << point.pin;
+            sep = " ";
+        }
+        std::cout << std::endl;
+        return 0;
+    }
+
     if (argc < 9) {
-        std::cerr << "Usage: ./bench <listlf|listwf|tree> <test_length_seconds> <element_size> <num_runs> <read_percent> <insert_percent> <delete_percent> <reclamation> [num_threads]\n\n"
+        std::cerr << "Usage: ./bench <listlf|listwf|tree> <test_length_seconds> <element_size> <num_runs> <read_percent> <insert_percent> <delete_percent> <reclamation> [num_threads] [options]\n"
+                  << "       ./bench --list-threads[=M[,M...]]\n"
+                  << "       ./bench --list-points[=M[,M...]]   (threads:pin for each point of the sweep)\n\n"
                   << "Arguments:\n"
                   << "  <listlf|listwf|tree>     : The data structure to test\n"
                   << "  <test_length_seconds>    : Duration of the test in seconds (e.g., 10)\n"
@@ -25,7 +144,66 @@ int main(int argc, char* argv[]) {
                   << "  <insert_percent>         : Percentage of insert operations (e.g., 10 or 10%)\n"
                   << "  <delete_percent>         : Percentage of delete operations (e.g., 10 or 10%)\n"
                   << "  <reclamation>            : HP | HPO | EBR | NR | IBR | HE | HYALINE\n"
-                  << "  [num_threads]            : (Optional) Number of threads to run (e.g., 64)\n\n"
+                  << "  [num_threads]            : (Optional) Number of threads to run (e.g., 64); by default, sweep\n"
+                  << "                             1, one core, one socket, all cores and all hardware threads\n\n"
+                  << "Options:\n"
+                  << "  --arena[=hugetlb|thp]    : Allocate nodes from per-thread 2MB arenas (MAP_HUGETLB when\n"
+                  << "                             available, otherwise THP via madvise; 'thp' skips MAP_HUGETLB)\n"
+                  << "  --dtlb                   : Report dTLB load misses per operation and the dTLB miss rate\n"
+                  << "  --perf                   : Report cycles, instructions (IPC), LLC, dTLB and branch misses\n"
+                  << "                             and memory-ordering machine clears per operation\n"
+                  << "  --numa                   : Place per-thread reclamation state and arena regions on the\n"
+                  << "                             local NUMA node (implies --arena=thp and --pin=compact unless\n"
+                  << "                             --arena or --pin is given)\n"
+                  << "  --latency[=N]            : Time every Nth operation (default: 1) and report p50/p99/p99.9/\n"
+                  << "                             p99.99/max latency for search, insert and remove\n"
+                  << "  --pin=P                  : Pin threads: compact, scatter (across sockets), smt (siblings\n"
+                  << "                             first) or a CPU list such as 0-7,16-23\n"
+                  << "  --dist=D                 : Key distribution: uniform (default), zipf[:theta],\n"
+                  << "                             hotspot[:frac[:prob]], sequential, window[:frac], latest[:theta]\n"
+                  << "  --prefill=R              : Prefill exactly R*num_elements distinct keys (0..1); by default,\n"
+                  << "                             num_elements/2 random draws\n"
+                  << "  --sample=MS[:file]       : Every MS milliseconds, record ops completed, unreclaimed nodes\n"
+                  << "                             and RSS, and write them to a CSV file (default: timeseries.csv)\n"
+                  << "  --stall=N:P:D            : Every P ms, make threads 0..N-1 sleep D ms inside an operation\n"
+                  << "                             while holding their reservation (combine with --sample)\n"
+                  << "  --oversub=F[,F...]       : Run F times as many threads as online CPUs (e.g., 2,4,8) instead\n"
+                  << "                             of [num_threads]; implies --latency unless it is given\n"
+                  << "  --sweep[=M[,M...]]       : Run the topology sweep (the default without [num_threads]), adding\n"
+                  << "                             M times all hardware threads; each point is pinned its own way\n"
+                  << "                             unless --pin is given\n"
+                  << "  --yield=N                : Call sched_yield() at every Nth stall point (mid-operation)\n"
+                  << "  --record=file            : Save the operations of the first run as a binary trace\n"
+                  << "  --replay=file            : Take operations and keys from a trace instead of the generators\n"
+                  << "  --ycsb=A..F              : YCSB core workload over key-value versions of the sets; replaces\n"
+                  << "                             the percentages; zipf/latest keys, full load unless given\n"
+                  << "  --value=BYTES            : Value stored in each list node and tree leaf (default: 0, or\n"
+                  << "                             1000 with --ycsb)\n"
+                  << "  --rate=OPS               : Open loop: offer OPS operations/sec in total, split evenly over\n"
+                  << "                             the threads; latency counts from the intended start (implies\n"
+                  << "                             --latency unless it is given)\n"
+                  << "  --arrivals=poisson|constant : Arrival process for --rate (default: poisson)\n"
+                  << "  --roles=N:MIX[,N:MIX...] : Split the threads into groups of N with their own mix (see\n"
+                  << "                             MIX below); other threads use the command-line mix\n"
+                  << "  --phases=MIX:S[,MIX:S...] : Run each mix for S seconds in turn instead of the percentages\n"
+                  << "                             and test_length (e.g., grow:5,churn:10,shrink:5,grow:5);\n"
+                  << "                             MIX:until=N[:S] ends the phase once N keys are in the structure\n"
+                  << "                             (at most S seconds, 60 by default); reports throughput,\n"
+                  << "                             size and unreclaimed nodes per phase\n"
+                  << "  --baselines              : Also run lock-based baselines (MutexSet, RWLockSet, SequentialSet;\n"
+                  << "                             HandOverHandLinkedList and LazyLinkedListEBR for the lists)\n"
+                  << "                             as extra columns of the final results\n"
+                  << "  --ci=PCT[:MAX]           : Warm up until the throughput settles, then repeat runs (at least\n"
+                  << "                             num_runs and 3, at most MAX, default 30) until the 95% confidence\n"
+                  << "                             interval is within PCT% of the mean; adds mean, CI, IQR, outliers\n"
+                  << "                             and Welch's t-tests between the data structures\n"
+                  << "  --bulkload               : Prefill by building a balanced tree or a linked list from the\n"
+                  << "                             sorted keys instead of inserting them\n"
+                  << "  --keys=int|string[:N]|id128 : Key type (default: int); nodes cache an 8-byte prefix of\n"
+                  << "                             string and 128-bit keys to avoid dereferencing them;\n"
+                  << "                             string:N pads string keys to N bytes (at least the longest key)\n\n"
+                  << "MIX: read, write or churn (50/50 insert/remove), grow (inserts only), shrink (removes only),\n"
+                  << "     scan (reads of up to 100 consecutive keys) or R/I/D[/S] percentages adding up to 100\n\n"
                   << "Note: Sum of read, insert, and delete percentages must not exceed 100.\n"
                   << std::endl;
         return 1;
@@ -65,14 +243,292 @@ int main(int argc, char* argv[]) {
     }
 
     int userThreadCount = -1;
-    if (argc >= 10) {
-        try {
-            userThreadCount = std::stoi(argv[9]);
-            if (userThreadCount <= 0) throw std::invalid_argument("Thread count must be positive");
-        } catch (...) {
-            std::cerr << "Invalid thread count provided in argument 10." << std::endl;
+    BenchOptions opts;
+    bool distGiven = false;
+    bool sweepGiven = false;
+    long valueBytes = -1;
+    for (int i = 9; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg.compare(0, 2, "--") != 0) {
+            try {
+                userThreadCount = std::stoi(arg);
+                if (userThreadCount <= 0) throw std::invalid_argument("Thread count must be positive");
+            } catch (...) {
+                std::cerr << "Invalid thread count provided in argument " << (i + 1) << "." << std::endl;
+                return 1;
+            }
+        } else if (arg == "--arena" || arg == "--arena=hugetlb") {
+            opts.arenaMode = NodeArena::ARENA_HUGETLB;
+        } else if (arg == "--arena=thp") {
+            opts.arenaMode = NodeArena::ARENA_THP;
+        } else if (arg == "--dtlb") {
+            opts.dtlb = true;
+        } else if (arg == "--perf") {
+            opts.perf = true;
+        } else if (arg == "--numa") {
+            opts.numa = true;
+        } else if (arg == "--latency") {
+            opts.latencySample = 1;
+        } else if (arg.compare(0, 10, "--latency=") == 0) {
+            try {
+                opts.latencySample = std::stoi(arg.substr(10));
+                if (opts.latencySample <= 0) throw std::invalid_argument("Sampling period must be positive");
+            } catch (...) {
+                std::cerr << "Invalid sampling period in " << arg << std::endl;
+                return 1;
+            }
+        } else if (arg.compare(0, 6, "--pin=") == 0) {
+            if (!Topology::configure(arg.substr(6))) {
+                std::cerr << "Invalid pinning policy or CPU list: " << arg << std::endl;
+                return 1;
+            }
+        } else if (arg.compare(0, 7, "--dist=") == 0) {
+            distGiven = true;
+            if (!KeyDistribution::parse(arg.substr(7), opts.keyDist)) {
+                std::cerr << "Invalid key distribution: " << arg << std::endl;
+                return 1;
+            }
+        } else if (arg.compare(0, 10, "--prefill=") == 0) {
+            char *end;
+            opts.prefillRatio = strtod(arg.c_str() + 10, &end);
+            if (*end != '\0' || end == arg.c_str() + 10 || opts.prefillRatio < 0 || opts.prefillRatio > 1) {
+                std::cerr << "Invalid prefill ratio in " << arg << " (expected 0..1)" << std::endl;
+                return 1;
+            }
+        } else if (arg.compare(0, 9, "--sample=") == 0) {
+            std::string spec = arg.substr(9);
+            size_t colon = spec.find(':');
+            if (colon != std::string::npos) {
+                opts.samplePath = spec.substr(colon + 1);
+                spec = spec.substr(0, colon);
+            }
+            try {
+                opts.sampleMs = std::stoi(spec);
+                if (opts.sampleMs <= 0 || opts.samplePath.empty()) throw std::invalid_argument("Bad sampling period");
+            } catch (...) {
+                std::cerr << "Invalid sampling period or file in " << arg << std::endl;
+                return 1;
+            }
+        } else if (arg.compare(0, 8, "--stall=") == 0) {
+            int threads, period, duration;
+            char end;
+            if (sscanf(arg.c_str() + 8, "%d:%d:%d%c", &threads, &period, &duration, &end) != 3 ||
+                    threads <= 0 || period <= 0 || duration <= 0) {
+                std::cerr << "Invalid stall specification in " << arg << " (expected THREADS:PERIOD_MS:DURATION_MS)" << std::endl;
+                return 1;
+            }
+            Stall::configure(threads, period, duration);
+        } else if (arg.compare(0, 10, "--oversub=") == 0) {
+            std::stringstream ss(arg.substr(10));
+            std::string factor;
+            while (std::getline(ss, factor, ',')) {
+                try {
+                    opts.oversub.push_back(std::stoi(factor));
+                    if (opts.oversub.back() <= 0) throw std::invalid_argument("Factor must be positive");
+                } catch (...) {
+                    std::cerr << "Invalid oversubscription factor in " << arg << std::endl;
+                    return 1;
+                }
+            }
+        } else if (arg == "--sweep") {
+            sweepGiven = true;
+        } else if (arg.compare(0, 8, "--sweep=") == 0) {
+            sweepGiven = true;
+            if (!parseMultiples(arg.substr(8), opts.sweepMultiples)) {
+                std::cerr << "Invalid sweep multiples in " << arg << std::endl;
+                return 1;
+            }
+        } else if (arg.compare(0, 8, "--yield=") == 0) {
+            try {
+                int every = std::stoi(arg.substr(8));
+                if (every <= 0) throw std::invalid_argument("Period must be positive");
+                Stall::configure_yield(every);
+            } catch (...) {
+                std::cerr << "Invalid yield period in " << arg << std::endl;
+                return 1;
+            }
+        } else if (arg.compare(0, 9, "--record=") == 0 && arg.size() > 9) {
+            opts.recordPath = arg.substr(9);
+        } else if (arg.compare(0, 9, "--replay=") == 0 && arg.size() > 9) {
+            if (!Trace::open(arg.substr(9))) return 1;
+        } else if (arg.compare(0, 7, "--ycsb=") == 0) {
+            if (arg.size() != 8 || Ycsb::workload(arg[7]) == nullptr) {
+                std::cerr << "Invalid YCSB workload in " << arg << " (expected A-F)" << std::endl;
+                return 1;
+            }
+            opts.ycsb = Ycsb::workload(arg[7])->name;
+        } else if (arg.compare(0, 8, "--value=") == 0) {
+            char *end;
+            valueBytes = strtol(arg.c_str() + 8, &end, 10);
+            if (*end != '\0' || end == arg.c_str() + 8 || valueBytes < 0 || valueBytes > (long) NodeValue::MAX_SIZE) {
+                std::cerr << "Invalid value size in " << arg << " (expected 0.." << NodeValue::MAX_SIZE << " bytes)" << std::endl;
+                return 1;
+            }
+        } else if (arg.compare(0, 7, "--rate=") == 0) {
+            char *end;
+            opts.rate = strtod(arg.c_str() + 7, &end);
+            if (*end != '\0' || end == arg.c_str() + 7 || !(opts.rate > 0)) {
+                std::cerr << "Invalid offered load in " << arg << " (expected operations per second)" << std::endl;
+                return 1;
+            }
+        } else if (arg == "--arrivals=poisson") {
+            opts.arrivals = OpenLoop::ARRIVALS_POISSON;
+        } else if (arg == "--arrivals=constant") {
+            opts.arrivals = OpenLoop::ARRIVALS_CONSTANT;
+        } else if (arg.compare(0, 8, "--roles=") == 0) {
+            if (!parseRoles(arg.substr(8), opts.roles)) {
+                std::cerr << "Invalid thread roles in " << arg << " (expected N:MIX,...)" << std::endl;
+                return 1;
+            }
+        } else if (arg.compare(0, 9, "--phases=") == 0) {
+            if (!parsePhases(arg.substr(9), opts.phases)) {
+                std::cerr << "Invalid phases in " << arg << " (expected MIX:SECONDS or MIX:until=N[:SECONDS],...)" << std::endl;
+                return 1;
+            }
+        } else if (arg == "--baselines") {
+            opts.baselines = true;
+        } else if (arg.compare(0, 5, "--ci=") == 0) {
+            char *end;
+            opts.ciTarget = strtod(arg.c_str() + 5, &end);
+            if (*end == ':') opts.ciMaxRuns = strtol(end + 1, &end, 10);
+            if (*end != '\0' || !(opts.ciTarget > 0 && opts.ciTarget < 100) || opts.ciMaxRuns < 3 || opts.ciMaxRuns > 1000) {
+                std::cerr << "Invalid confidence target in " << arg << " (expected PCT[:MAX_RUNS], 0 < PCT < 100, 3 <= MAX_RUNS <= 1000)" << std::endl;
+                return 1;
+            }
+        } else if (arg == "--bulkload") {
+            opts.bulkLoad = true;
+        } else if (arg == "--keys=int") {
+            opts.keyType = KEY_INT;
+        } else if (arg == "--keys=string") {
+            opts.keyType = KEY_STRING;
+        } else if (arg.compare(0, 14, "--keys=string:") == 0) {
+            char *end;
+            long length = strtol(arg.c_str() + 14, &end, 10);
+            if (*end != '\0' || end == arg.c_str() + 14 || length < 1 || length > (long) StringKey::MAX_LENGTH) {
+                std::cerr << "Invalid key size in " << arg << " (expected 1.." << StringKey::MAX_LENGTH << " bytes)" << std::endl;
+                return 1;
+            }
+            opts.keyType = KEY_STRING;
+            StringKey::length() = length;
+        } else if (arg == "--keys=id128") {
+            opts.keyType = KEY_ID128;
+        } else {
+            std::cerr << "Unknown option: " << arg << std::endl;
+            return 1;
+        }
+    }
+
+    if (sweepGiven && (userThreadCount > 0 || !opts.oversub.empty())) {
+        std::cerr << "--sweep replaces the thread count and --oversub; do not combine them" << std::endl;
+        return 1;
+    }
+
+    if (!opts.oversub.empty()) {
+        if (userThreadCount > 0) {
+            std::cerr << "--oversub replaces the thread count; do not give both" << std::endl;
             return 1;
         }
+        // Preempted operations show up in the tail first
+        if (opts.latencySample == 0) opts.latencySample = 1;
+    }
+
+    // Open-loop latency is the point of --rate
+    if (opts.rate > 0 && opts.latencySample == 0) opts.latencySample = 1;
+
+    if (opts.ycsb) {
+        if (Trace::replaying() || !opts.recordPath.empty()) {
+            std::cerr << "--ycsb cannot be combined with --record or --replay" << std::endl;
+            return 1;
+        }
+        // The workload's own distribution, load and record size unless given
+        const Ycsb::Workload *w = Ycsb::workload(opts.ycsb);
+        if (!distGiven) opts.keyDist.type = w->dist;
+        if (opts.prefillRatio < 0) opts.prefillRatio = w->prefill;
+        if (valueBytes < 0) valueBytes = 1000;
+    }
+#ifdef SCOT_COMPACT_LINKS
+    // A node with its value must fit a size class, or it comes from the heap and has no 32-bit reference
+    if (valueBytes > (long) (NodeArena::CLASS_UNIT * NodeArena::NUM_CLASSES - NodeValue::NODE_ROOM)) {
+        std::cerr << "Compact links need --value of at most " << NodeArena::CLASS_UNIT * NodeArena::NUM_CLASSES - NodeValue::NODE_ROOM
+                  << " bytes, so that nodes stay in the arena" << (opts.ycsb ? " (YCSB stores 1000 bytes by default)" : "") << std::endl;
+        return 1;
+    }
+#endif
+    if (valueBytes > 0) NodeValue::configure(valueBytes);
+
+    if (!opts.roles.empty() && (opts.ycsb || Trace::replaying() || !opts.recordPath.empty())) {
+        std::cerr << "--roles cannot be combined with --ycsb, --record or --replay" << std::endl;
+        return 1;
+    }
+
+    if (!opts.phases.empty()) {
+        if (opts.ycsb || Trace::replaying() || !opts.recordPath.empty() || !opts.roles.empty()) {
+            std::cerr << "--phases cannot be combined with --ycsb, --record, --replay or --roles" << std::endl;
+            return 1;
+        }
+        for (const Phase &phase : opts.phases) {
+            if (phase.until > elementSize) {
+                std::cerr << "--phases: " << phase.mix.name << ":until=" << phase.until << " exceeds the " << elementSize << " keys" << std::endl;
+                return 1;
+            }
+        }
+        // The phases make up the whole run; until=N phases may end it earlier
+        testLengthSeconds = 0;
+        for (const Phase &phase : opts.phases) testLengthSeconds += phase.seconds;
+    }
+
+    if (opts.keyType == KEY_STRING) {
+        // Shorter padding would leave the longer keys as they are
+        StringKey::longest() = StringKey::natural(elementSize > 0 ? elementSize - 1 : 0);
+        if (StringKey::length() > 0 && StringKey::length() < StringKey::longest()) {
+            std::cerr << "--keys=string:" << StringKey::length() << " is shorter than the " << StringKey::longest()
+                      << "-byte keys of " << elementSize << " elements" << std::endl;
+            return 1;
+        }
+    }
+
+    if (Trace::replaying() && Trace::num_elements() > (uint64_t) elementSize) {
+        std::cerr << "The trace indexes " << Trace::num_elements() << " elements, more than " << elementSize << std::endl;
+        return 1;
+    }
+
+    if (!opts.recordPath.empty() && (uint64_t) elementSize > Trace::KEY_MASK + 1ULL) {
+        std::cerr << "Traces hold at most " << Trace::KEY_MASK + 1ULL << " elements" << std::endl;
+        return 1;
+    }
+
+    if (opts.sampleMs > 0 && !TimeSeries::create(opts.samplePath)) {
+        std::cerr << "Cannot create " << opts.samplePath << std::endl;
+        return 1;
+    }
+
+    if (opts.numa && Topology::current_policy() == Topology::PIN_NONE && (userThreadCount > 0 || !opts.oversub.empty())) {
+        // The state of thread 'tid' goes to the node of the CPU it is pinned to; the sweep pins every point itself
+        Topology::configure("compact");
+    }
+
+    if (Topology::current_policy() != Topology::PIN_NONE) {
+        std::cout << "Thread pinning: " << Topology::policy_name() << " (" << Topology::num_cpus()
+                  << " CPUs, " << Topology::num_sockets() << " sockets)\n";
+    }
+
+    if (opts.numa) {
+        // Nodes go back to their owner's pool, which lives in the arena
+        if (opts.arenaMode == NodeArena::ARENA_OFF) opts.arenaMode = NodeArena::ARENA_THP;
+        if (Numa::enable()) {
+            std::cout << "NUMA placement: " << Numa::nodes() << " nodes\n";
+        } else {
+            std::cout << "NUMA placement: single node, using regular allocation\n";
+        }
+    }
+
+#ifdef SCOT_COMPACT_LINKS
+    // 32-bit links name nodes by their offset in the arena
+    if (opts.arenaMode == NodeArena::ARENA_OFF) opts.arenaMode = NodeArena::ARENA_THP;
+#endif
+
+    if (!NodeArena::enable(static_cast<NodeArena::Mode>(opts.arenaMode))) {
+        return 1;
     }
 
     BenchmarkLists::allThroughputTests(
@@ -84,7 +540,8 @@ int main(int argc, char* argv[]) {
         insertPercent,
         deletePercent,
         reclamation,
-        userThreadCount
+        userThreadCount,
+        opts
     );
 
     return 0;
@@ -0,0 +1,465 @@
+/*
+ * Copyright (c) 2024-2025, Md Amit Hasan Arovi, Ruslan Nikolaev
+ * All Rights Reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/*
+ * Cost of the reclamation primitives on their own, without a data
+ * structure around them.
+ *
+ * All threads call the same primitive at the same time, so shared
+ * counters (eras, epochs) and the scans over other threads' reservations
+ * see the contention they would see in a data structure. Each primitive
+ * is timed over a loop of calls; retire() is timed call by call to get
+ * the worst case and the cost of the calls that scan.
+ *
+ * The backlog is the number of nodes each thread retires before the
+ * measurement while a spare reservation slot (tid = threads) holds them:
+ * a started operation for EBR, IBR and Hyaline, and an era for HE. The
+ * scans then meet that many nodes they cannot free. HP and HPO free every
+ * unprotected node on each scan, so they cannot carry a backlog; their
+ * scan grows with the number of threads instead.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+#include "HazardPointers.hpp"
+#include "HazardPointersOrig.hpp"
+#include "HazardEras.hpp"
+#include "IBR.hpp"
+#include "EBR.hpp"
+#include "Hyaline.hpp"
+#include "LatencyHistogram.hpp"
+#include "Topology.hpp"
+
+enum Primitive {
+    PROTECT = 0,
+    PROTECT_RELEASE = 1,
+    START_END_OP = 2,
+    INIT_OBJECT = 3,
+    RETIRE_AVG = 4,
+    RETIRE_MAX = 5,
+    SCAN = 6,
+    NUM_PRIMITIVES = 7
+};
+
+static const char *primitiveNames[NUM_PRIMITIVES] = {
+    "protect", "protect_release", "start_end_op", "init_object", "retire_avg", "retire_max", "scan"
+};
+
+// Every scheme scans (or, for Hyaline, hands over a batch) once per this
+// many retire() calls: HP_THRESHOLD_R, HE_THRESHOLD_R and empty_freq
+static const long long SCAN_EVERY = 128;
+
+// Retired nodes are allocated in chunks of this size outside the timing
+static const long long RETIRE_CHUNK = 1024;
+
+template<typename Base>
+struct MicroNode : Base {
+    long long payload = 0;
+};
+
+/*
+ * One adapter per scheme. begin()/end() bracket the calls the way a data
+ * structure operation does; primitives a scheme does not have are
+ * reported as n/a.
+ */
+template<template<typename> class Scheme>
+struct HPAdapter {
+    typedef MicroNode<ArenaNode> Node;
+    static const bool HAS_PROTECT = true, HAS_RELEASE = true, HAS_OP = false, HAS_INIT = false, HAS_BACKLOG = false;
+
+    Scheme<Node> smr;
+
+    HPAdapter(int maxThreads) : smr(1, maxThreads) { }
+
+    inline void begin(int tid) { }
+    inline void end(int tid) { smr.clear(tid); }
+    inline Node *protect(const std::atomic<Node*> &atom, int tid) { return smr.protect(0, atom, tid); }
+    inline void release(Node *node, int tid) { smr.protectPtrRelease(0, node, tid); }
+    inline Node *init(Node *node, int tid) { return node; }
+    inline void retire(Node *node, int tid) { smr.retire(node, tid); }
+    void pin(int tid) { }
+    void unpin(int tid) { }
+};
+
+struct HEAdapter {
+    typedef MicroNode<HENode> Node;
+    static const bool HAS_PROTECT = true, HAS_RELEASE = true, HAS_OP = false, HAS_INIT = true, HAS_BACKLOG = true;
+
+    HazardEras<Node> smr;
+    std::atomic<Node*> pinLink = { nullptr };
+
+    HEAdapter(int maxThreads) : smr(2, maxThreads) { }
+
+    inline void begin(int tid) { }
+    inline void end(int tid) { smr.clear(tid); }
+    inline Node *protect(const std::atomic<Node*> &atom, int tid) { return smr.protect(0, atom, tid); }
+    // The lists hand a reservation over with protectEraRelease()
+    inline void release(Node *node, int tid) { smr.protectEraRelease(1, 0, tid); }
+    inline Node *init(Node *node, int tid) { return smr.init_object(node, tid); }
+    inline void retire(Node *node, int tid) { smr.retire(node, tid); }
+    void pin(int tid) { smr.protect(0, pinLink, tid); }
+    void unpin(int tid) { smr.clear(tid); }
+};
+
+struct IBRAdapter {
+    typedef MicroNode<IBRNode> Node;
+    static const bool HAS_PROTECT = true, HAS_RELEASE = false, HAS_OP = true, HAS_INIT = true, HAS_BACKLOG = true;
+
+    IBR<Node> smr;
+
+    IBRAdapter(int maxThreads) : smr(maxThreads) { }
+
+    inline void begin(int tid) { smr.start_op(tid); }
+    inline void end(int tid) { smr.end_op(tid); }
+    inline Node *protect(const std::atomic<Node*> &atom, int tid) { return smr.protect(atom, tid); }
+    inline void release(Node *node, int tid) { }
+    inline Node *init(Node *node, int tid) { return smr.init_object(node, tid); }
+    inline void retire(Node *node, int tid) { smr.retire(node, tid); }
+    void pin(int tid) { smr.start_op(tid); }
+    void unpin(int tid) { smr.end_op(tid); }
+};
+
+struct EBRAdapter {
+    typedef MicroNode<EBRNode> Node;
+    static const bool HAS_PROTECT = false, HAS_RELEASE = false, HAS_OP = true, HAS_INIT = false, HAS_BACKLOG = true;
+
+    EBR smr;
+
+    EBRAdapter(int maxThreads) : smr(maxThreads) { }
+
+    inline void begin(int tid) { smr.start_op(tid); }
+    inline void end(int tid) { smr.end_op(tid); }
+    inline Node *protect(const std::atomic<Node*> &atom, int tid) { return atom.load(); }
+    inline void release(Node *node, int tid) { }
+    inline Node *init(Node *node, int tid) { return node; }
+    inline void retire(Node *node, int tid) { smr.retire(node, tid); }
+    void pin(int tid) { smr.start_op(tid); }
+    void unpin(int tid) { smr.end_op(tid); }
+};
+
+struct HyalineAdapter {
+    typedef MicroNode<HyalineNode> Node;
+    static const bool HAS_PROTECT = true, HAS_RELEASE = false, HAS_OP = true, HAS_INIT = true, HAS_BACKLOG = true;
+
+    Hyaline<Node> smr;
+
+    HyalineAdapter(int maxThreads) : smr(maxThreads) { }
+
+    inline void begin(int tid) { smr.start_op(tid); }
+    inline void end(int tid) { smr.end_op(tid); }
+    inline Node *protect(const std::atomic<Node*> &atom, int tid) { return smr.protect(atom, tid); }
+    inline void release(Node *node, int tid) { }
+    inline Node *init(Node *node, int tid) { return smr.init_object(node, tid); }
+    inline void retire(Node *node, int tid) { smr.retire(node, tid); }
+    void pin(int tid) { smr.start_op(tid); }
+    void unpin(int tid) { smr.end_op(tid); }
+};
+
+class SpinBarrier {
+private:
+    const int parties;
+    std::atomic<int> waiting = { 0 };
+    std::atomic<int> generation = { 0 };
+
+public:
+    explicit SpinBarrier(int n) : parties(n) { }
+
+    void wait()
+    {
+        const int gen = generation.load();
+        if (waiting.fetch_add(1) + 1 == parties) {
+            waiting.store(0);
+            generation.fetch_add(1);
+        } else {
+            while (generation.load() == gen) std::this_thread::yield();
+        }
+    }
+};
+
+struct MicroOptions {
+    long long calls = 1000000;              // --calls=N: per thread, for each cheap primitive
+    long long retires = 100000;             // --retires=N: per thread
+    std::vector<int> threads;               // --threads=T[,T...]
+    std::vector<long long> backlogs;        // --backlog=B[,B...]
+    std::vector<std::string> schemes;       // --schemes=S[,S...]
+};
+
+// Cost of reading the clock twice in a row, taken off each timed retire()
+static uint64_t timerOverhead()
+{
+    uint64_t best = UINT64_MAX;
+    for (int i = 0; i < 1000; i++) {
+        const uint64_t t0 = LatencyHistogram::now();
+        const uint64_t t1 = LatencyHistogram::now();
+        if (t1 - t0 < best) best = t1 - t0;
+    }
+    return best;
+}
+
+/**
+ * Runs every primitive of scheme 'A' on 'numThreads' threads and prints
+ * one row, in nanoseconds per call
+ */
+template<typename A>
+static void measure(const std::string &name, int numThreads, long long backlog, const MicroOptions &opts)
+{
+    typedef typename A::Node Node;
+    const double tpn = LatencyHistogram::ticksPerNs();
+    const uint64_t overhead = timerOverhead();
+    const int pinTid = numThreads;
+    // The spare slot holds the backlog
+    std::unique_ptr<A> smr(new A(numThreads + 1));
+    std::vector<double> perCall(numThreads * NUM_PRIMITIVES, 0);
+    std::vector<LatencyHistogram> retireHist(numThreads);
+    std::atomic<Node*> link = { new Node() };
+    std::atomic<uintptr_t> sink = { 0 };
+    SpinBarrier barrier(numThreads + 1);
+    if (!A::HAS_BACKLOG) backlog = 0;
+
+    auto worker = [&](const int tid) {
+        Topology::pin(tid);
+        double *out = &perCall[tid * NUM_PRIMITIVES];
+        const long long calls = opts.calls;
+        uintptr_t local = 0;
+
+        // Backlog: allocated before the spare slot reserves, retired after
+        std::vector<Node*> held(backlog);
+        for (auto &node : held) node = smr->init(new Node(), tid);
+        barrier.wait();
+        barrier.wait();
+        for (auto node : held) smr->retire(node, tid);
+        barrier.wait();
+
+        if (A::HAS_PROTECT) {
+            smr->begin(tid);
+            const uint64_t t0 = LatencyHistogram::now();
+            for (long long i = 0; i < calls; i++) local += (uintptr_t) smr->protect(link, tid);
+            out[PROTECT] = (LatencyHistogram::now() - t0) / tpn / calls;
+            smr->end(tid);
+        }
+        barrier.wait();
+
+        if (A::HAS_RELEASE) {
+            Node *node = smr->protect(link, tid);
+            const uint64_t t0 = LatencyHistogram::now();
+            for (long long i = 0; i < calls; i++) smr->release(node, tid);
+            out[PROTECT_RELEASE] = (LatencyHistogram::now() - t0) / tpn / calls;
+            smr->end(tid);
+        }
+        barrier.wait();
+
+        if (A::HAS_OP) {
+            const uint64_t t0 = LatencyHistogram::now();
+            for (long long i = 0; i < calls; i++) {
+                smr->begin(tid);
+                smr->end(tid);
+            }
+            out[START_END_OP] = (LatencyHistogram::now() - t0) / tpn / calls;
+        }
+        barrier.wait();
+
+        if (A::HAS_INIT) {
+            Node *node = new Node();
+            const uint64_t t0 = LatencyHistogram::now();
+            for (long long i = 0; i < calls; i++) local += (uintptr_t) smr->init(node, tid);
+            out[INIT_OBJECT] = (LatencyHistogram::now() - t0) / tpn / calls;
+            delete node;
+        }
+        barrier.wait();
+
+        // retire(), one call at a time
+        LatencyHistogram &hist = retireHist[tid];
+        uint64_t total = 0;
+        std::vector<Node*> chunk(RETIRE_CHUNK);
+        for (long long done = 0; done < opts.retires; done += RETIRE_CHUNK) {
+            const long long n = std::min(RETIRE_CHUNK, opts.retires - done);
+            for (long long i = 0; i < n; i++) chunk[i] = smr->init(new Node(), tid);
+            for (long long i = 0; i < n; i++) {
+                const uint64_t t0 = LatencyHistogram::now();
+                smr->retire(chunk[i], tid);
+                uint64_t t = LatencyHistogram::now() - t0;
+                t = (t > overhead) ? t - overhead : 0;
+                hist.record(t);
+                total += t;
+            }
+        }
+        out[RETIRE_AVG] = total / tpn / opts.retires;
+        sink.fetch_add(local, std::memory_order_relaxed);
+        barrier.wait();
+    };
+
+    std::vector<std::thread> workers;
+    for (int tid = 0; tid < numThreads; tid++) workers.emplace_back(worker, tid);
+    barrier.wait();
+    if (backlog > 0) smr->pin(pinTid);
+    barrier.wait();
+    for (int phase = 0; phase < 6; phase++) barrier.wait();
+    for (auto &t : workers) t.join();
+    if (backlog > 0) smr->unpin(pinTid);
+
+    // Means over the threads, and the retire() distribution of all of them
+    double result[NUM_PRIMITIVES] = { 0 };
+    LatencyHistogram retires;
+    for (int tid = 0; tid < numThreads; tid++) {
+        for (int p = 0; p < NUM_PRIMITIVES; p++) result[p] += perCall[tid * NUM_PRIMITIVES + p] / numThreads;
+        retires.merge(retireHist[tid]);
+    }
+    result[RETIRE_MAX] = retires.max() / tpn;
+    // The median of the slowest 1/SCAN_EVERY calls, i.e., of those that scan
+    result[SCAN] = retires.percentile(100. - 50. / SCAN_EVERY) / tpn;
+
+    const bool has[NUM_PRIMITIVES] = { A::HAS_PROTECT, A::HAS_RELEASE, A::HAS_OP, A::HAS_INIT, true, true, true };
+    std::cout << name << ", " << numThreads << ", " << backlog;
+    for (int p = 0; p < NUM_PRIMITIVES; p++) {
+        std::cout << ", ";
+        if (has[p]) std::cout << std::fixed << std::setprecision(1) << result[p]; else std::cout << "n/a";
+    }
+    std::cout << std::endl;
+    delete link.load();
+}
+
+template<typename T>
+static bool parseList(const std::string &spec, std::vector<T> &out)
+{
+    std::stringstream ss(spec);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        char *end;
+        long long v = strtoll(item.c_str(), &end, 10);
+        if (*end != '\0' || end == item.c_str() || v < 0) return false;
+        out.push_back((T) v);
+    }
+    return !out.empty();
+}
+
+int main(int argc, char* argv[]) {
+    MicroOptions opts;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg.compare(0, 8, "--calls=") == 0) {
+            opts.calls = atoll(arg.c_str() + 8);
+            if (opts.calls <= 0) {
+                std::cerr << "Invalid call count in " << arg << std::endl;
+                return 1;
+            }
+        } else if (arg.compare(0, 10, "--retires=") == 0) {
+            opts.retires = atoll(arg.c_str() + 10);
+            if (opts.retires <= 0) {
+                std::cerr << "Invalid retire count in " << arg << std::endl;
+                return 1;
+            }
+        } else if (arg.compare(0, 10, "--threads=") == 0) {
+            if (!parseList(arg.substr(10), opts.threads)) {
+                std::cerr << "Invalid thread list in " << arg << std::endl;
+                return 1;
+            }
+        } else if (arg.compare(0, 10, "--backlog=") == 0) {
+            if (!parseList(arg.substr(10), opts.backlogs)) {
+                std::cerr << "Invalid backlog list in " << arg << std::endl;
+                return 1;
+            }
+        } else if (arg.compare(0, 10, "--schemes=") == 0) {
+            std::stringstream ss(arg.substr(10));
+            std::string s;
+            while (std::getline(ss, s, ',')) opts.schemes.push_back(s);
+        } else if (arg.compare(0, 6, "--pin=") == 0) {
+            if (!Topology::configure(arg.substr(6))) {
+                std::cerr << "Invalid pinning policy or CPU list: " << arg << std::endl;
+                return 1;
+            }
+        } else {
+            std::cerr << "Usage: ./microbench [options]\n\n"
+                      << "Options:\n"
+                      << "  --threads=T[,T...]       : Thread counts (default: powers of two up to the online CPUs)\n"
+                      << "  --backlog=B[,B...]       : Nodes each thread keeps on its retired list during the\n"
+                      << "                             measurement (default: 0,1024,16384)\n"
+                      << "  --schemes=S[,S...]       : HP | HPO | HE | IBR | EBR | HYALINE (default: all)\n"
+                      << "  --calls=N                : Calls per thread for each cheap primitive (default: 1000000)\n"
+                      << "  --retires=N              : retire() calls per thread (default: 100000)\n"
+                      << "  --pin=P                  : Pin threads, as in bench\n"
+                      << std::endl;
+            return 1;
+        }
+    }
+    if (opts.threads.empty()) {
+        const int cpus = (int) sysconf(_SC_NPROCESSORS_ONLN);
+        for (int t = 1; t < cpus; t *= 2) opts.threads.push_back(t);
+        opts.threads.push_back(cpus);
+    }
+    if (opts.backlogs.empty()) opts.backlogs = { 0, 1024, 16384 };
+    if (opts.schemes.empty()) opts.schemes = { "HP", "HPO", "HE", "IBR", "EBR", "HYALINE" };
+    for (int t : opts.threads) {
+        // One slot of the 384 the schemes support holds the backlog
+        if (t <= 0 || t > 383) {
+            std::cerr << "Thread counts must be between 1 and 383" << std::endl;
+            return 1;
+        }
+    }
+    for (const std::string &scheme : opts.schemes) {
+        if (scheme != "HP" && scheme != "HPO" && scheme != "HE" && scheme != "IBR" && scheme != "EBR" && scheme != "HYALINE") {
+            std::cerr << "Invalid reclamation scheme " << scheme << ". Use: HP | HPO | HE | IBR | EBR | HYALINE\n";
+            return 1;
+        }
+    }
+
+    std::cout << "Reclamation primitives: " << opts.calls << " calls and " << opts.retires
+              << " retires per thread, ns per call\n";
+    std::cout << "Scheme, Threads, Backlog";
+    for (int p = 0; p < NUM_PRIMITIVES; p++) std::cout << ", " << primitiveNames[p];
+    std::cout << "\n";
+    for (const std::string &scheme : opts.schemes) {
+        for (int threads : opts.threads) {
+            for (long long backlog : opts.backlogs) {
+                if (scheme == "HP") {
+                    // No backlog: one row per thread count
+                    if (backlog == opts.backlogs.front()) measure<HPAdapter<HazardPointers>>(scheme, threads, backlog, opts);
+                } else if (scheme == "HPO") {
+                    if (backlog == opts.backlogs.front()) measure<HPAdapter<HazardPointersOrig>>(scheme, threads, backlog, opts);
+                } else if (scheme == "HE") {
+                    measure<HEAdapter>(scheme, threads, backlog, opts);
+                } else if (scheme == "IBR") {
+                    measure<IBRAdapter>(scheme, threads, backlog, opts);
+                } else if (scheme == "EBR") {
+                    measure<EBRAdapter>(scheme, threads, backlog, opts);
+                } else {
+                    measure<HyalineAdapter>(scheme, threads, backlog, opts);
+                }
+            }
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,46 @@
+#!/bin/bash
+
+set -euo pipefail
+
+# Sanity check of the unreclaimed-memory accounting: under deletes, every
+# scheme but NR must report a non-zero memory_usage and a non-zero
+# unreclaimed_nodes column in the time series, for the lists and the tree.
+# Exits with 1 if any of them stays at 0.
+
+threads=4
+
+# guard against CRLF endings
+if grep -q $'\r' "$0"; then
+  echo "ERROR: Script has Windows CRLF endings. Run: sed -i 's/\r$//' $0" >&2
+  exit 1
+fi
+
+# project root
+cd "$(dirname "$0")/.." || { echo "Failed to navigate to project root"; exit 1; }
+
+# build
+cd SCOT || { echo "Failed to enter SCOT"; exit 1; }
+make bench
+cd ..
+
+schemes=(EBR HP HPO IBR HE HYALINE)
+series="$(mktemp)"
+trap 'rm -f "$series"' EXIT
+
+failed=0
+for ds in listlf tree; do
+  for scheme in "${schemes[@]}"; do
+    log="$(./SCOT/bench "$ds" 1 10000 1 0 50 50 "$scheme" "$threads" --sample=10:"$series" 2>&1)"
+    # The smallest over the data structures of the run (both lists for listlf)
+    mem="$(printf "%s\n" "$log" | sed -n '/MEDIAN RESULT/,$p' | awk '/^memory_usage = /{if (min == "" || $3 < min) min = $3} END {print min + 0}')"
+    peak="$(awk -F, 'NR > 1 && $7 > max[$1] {max[$1] = $7} NR > 1 {seen[$1] = 1}
+                     END {for (b in seen) if (min == "" || max[b] + 0 < min) min = max[b] + 0; print min + 0}' "$series")"
+    if [ "$mem" -gt 0 ] && [ "$peak" -gt 0 ]; then
+      echo "$ds $scheme: ok (memory_usage = $mem, peak unreclaimed_nodes = $peak)"
+    else
+      echo "$ds $scheme: FAILED (memory_usage = $mem, peak unreclaimed_nodes = $peak)"
+      failed=1
+    fi
+  done
+done
+exit $failed
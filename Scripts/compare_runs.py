@@ -0,0 +1,115 @@
+import argparse
+import math
+import re
+import sys
+
+# Compares the per-run throughput of bench logs with Welch's t-test.
+#
+#   ./SCOT/bench tree 10 100000 5 50 25 25 EBR 64 --ci=1 > ebr.log
+#   ./SCOT/bench tree 10 100000 5 50 25 25 IBR 64 --ci=1 > ibr.log
+#   python3 compare_runs.py ebr.log ibr.log
+#
+# Every "#### RUN k RESULT" section contributes one sample, keyed by the
+# benchmark, the thread count and the placement. For each thread count the
+# benchmarks are ranked by mean throughput, and each one is tested against
+# the next one down, as bench --ci does within one invocation.
+
+RUN_RE = re.compile(r"^#### RUN \d+ RESULT")
+HEADER_RE = re.compile(r"^----- Benchmark=(\S+)\s+numElements=\d+\s+numThreads=(\d+)(?:\s+placement=(\S+))?")
+OPS_RE = re.compile(r"^Ops/sec = (\d+)")
+
+
+def read_runs(path, runs):
+    in_run, key = False, None
+    with open(path) as f:
+        for line in f:
+            if RUN_RE.match(line):
+                in_run, key = True, None
+            elif line.startswith("######"):
+                in_run = False
+            elif in_run and key is None:
+                m = HEADER_RE.match(line)
+                if m:
+                    key = (int(m.group(2)), m.group(3) or "", m.group(1))
+            elif in_run and key is not None:
+                m = OPS_RE.match(line)
+                if m:
+                    runs.setdefault(key, []).append(int(m.group(1)))
+                    in_run = False
+
+
+def mean(x):
+    return sum(x) / len(x)
+
+
+def variance(x):
+    m = mean(x)
+    return sum((v - m) ** 2 for v in x) / (len(x) - 1)
+
+
+def incomplete_beta(a, b, x):
+    # Regularized I_x(a, b) by its continued fraction (modified Lentz)
+    if x <= 0:
+        return 0.0
+    if x >= 1:
+        return 1.0
+    if x >= (a + 1) / (a + b + 2):
+        return 1.0 - incomplete_beta(b, a, 1 - x)
+    front = math.exp(math.lgamma(a + b) - math.lgamma(a) - math.lgamma(b) + a * math.log(x) + b * math.log(1 - x))
+    tiny = 1e-300
+    c, d = 1.0, 1.0 - (a + b) * x / (a + 1)
+    d = 1.0 / (d if abs(d) > tiny else tiny)
+    h = d
+    for m in range(1, 301):
+        for aa in (m * (b - m) * x / ((a + 2 * m - 1) * (a + 2 * m)),
+                   -(a + m) * (a + b + m) * x / ((a + 2 * m) * (a + 2 * m + 1))):
+            d = 1.0 + aa * d
+            d = 1.0 / (d if abs(d) > tiny else tiny)
+            c = 1.0 + aa / c
+            c = c if abs(c) > tiny else tiny
+            h *= d * c
+        if abs(d * c - 1.0) < 1e-14:
+            break
+    return front * h / a
+
+
+def welch(a, b):
+    # Two-sided p-value of equal means
+    va, vb = variance(a) / len(a), variance(b) / len(b)
+    if va + vb == 0:
+        return 1.0 if mean(a) == mean(b) else 0.0
+    t = (mean(a) - mean(b)) / math.sqrt(va + vb)
+    df = (va + vb) ** 2 / (va * va / (len(a) - 1) + vb * vb / (len(b) - 1))
+    return incomplete_beta(df / 2, 0.5, df / (df + t * t))
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Compare the per-run throughput of bench logs")
+    parser.add_argument("logs", nargs="+", help="bench output files")
+    parser.add_argument("--alpha", type=float, default=0.05, help="significance level (default: 0.05)")
+    args = parser.parse_args()
+
+    runs = {}
+    for path in args.logs:
+        read_runs(path, runs)
+    if not runs:
+        sys.exit("No per-run results found")
+
+    points = sorted({(threads, placement) for threads, placement, _ in runs})
+    for threads, placement in points:
+        ranked = sorted(((name, ops) for (t, p, name), ops in runs.items() if (t, p) == (threads, placement)),
+                        key=lambda item: -mean(item[1]))
+        tag = "%d%s" % (threads, " " + placement if placement else "")
+        for (hi_name, hi), (lo_name, lo) in zip(ranked, ranked[1:]):
+            if len(hi) < 2 or len(lo) < 2:
+                print("%s: %s, %s: fewer than 2 runs, no test" % (tag, hi_name, lo_name))
+                continue
+            p = welch(hi, lo)
+            diff = 100.0 * (mean(hi) - mean(lo)) / mean(lo) if mean(lo) else 0.0
+            print("%s: %s %s %s   diff = %.1f%%   p = %.3g%s" % (
+                tag, hi_name, ">" if p < args.alpha else "~", lo_name, diff, p,
+                "" if p < args.alpha else "   (not significant)"))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,82 @@
+import argparse
+import random
+import struct
+import sys
+from array import array
+
+# Writes an operation trace for bench --replay (format: SCOT/Trace.hpp).
+#
+#   python3 generate_trace.py out.trace --threads 64 --ops 1000000 \
+#       --elements 100000 --mix 50,25,25 --dist zipf --theta 0.99
+#
+# A production trace can be converted the same way: build one list of
+# (op, key index) pairs per thread and pass them to write_trace().
+
+MAGIC = b"SCOTTRC1"
+KEY_BITS = 30
+OP_SEARCH, OP_INSERT, OP_REMOVE = 0, 1, 2
+
+
+def write_trace(path, num_elements, streams):
+    with open(path, "wb") as f:
+        f.write(struct.pack("<8sIIQ", MAGIC, len(streams), KEY_BITS, num_elements))
+        for stream in streams:
+            f.write(struct.pack("<Q", len(stream)))
+        for stream in streams:
+            stream.tofile(f)
+
+
+def zipf_sampler(n, theta, rng):
+    # Gray et al., "Quickly generating billion-record synthetic databases"
+    zetan = sum(1.0 / (i ** theta) for i in range(1, n + 1))
+    zeta2 = 1.0 + 0.5 ** theta
+    alpha = 1.0 / (1.0 - theta)
+    eta = (1.0 - (2.0 / n) ** (1.0 - theta)) / (1.0 - zeta2 / zetan)
+
+    def sample():
+        u = rng.random()
+        uz = u * zetan
+        if uz < 1.0:
+            return 0
+        if uz < zeta2:
+            return 1
+        return min(n - 1, int(n * (eta * u - eta + 1.0) ** alpha))
+    return sample
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Generate an operation trace for bench --replay")
+    parser.add_argument("output")
+    parser.add_argument("--threads", type=int, default=1)
+    parser.add_argument("--ops", type=int, default=1000000, help="operations per thread")
+    parser.add_argument("--elements", type=int, required=True, help="num_elements of the benchmark")
+    parser.add_argument("--mix", default="50,25,25", help="read,insert,delete percentages")
+    parser.add_argument("--dist", choices=["uniform", "zipf"], default="uniform")
+    parser.add_argument("--theta", type=float, default=0.99)
+    parser.add_argument("--seed", type=int, default=1)
+    args = parser.parse_args()
+
+    read, insert, delete = (int(x) for x in args.mix.split(","))
+    if read + insert + delete != 100 or min(read, insert, delete) < 0:
+        sys.exit("--mix must be three percentages that add up to 100")
+    if not 0 < args.elements <= (1 << KEY_BITS):
+        sys.exit("--elements must be between 1 and 2^30")
+
+    streams = []
+    for tid in range(args.threads):
+        rng = random.Random(args.seed * 1000003 + tid)
+        key = zipf_sampler(args.elements, args.theta, rng) if args.dist == "zipf" \
+            else (lambda: rng.randrange(args.elements))
+        stream = array("I")
+        for _ in range(args.ops):
+            p = rng.randrange(100)
+            op = OP_SEARCH if p < read else OP_INSERT if p < read + insert else OP_REMOVE
+            stream.append((op << KEY_BITS) | key())
+        if sys.byteorder != "little":
+            stream.byteswap()
+        streams.append(stream)
+    write_trace(args.output, args.elements, streams)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,47 @@
+#!/bin/bash
+
+exec >run_compact.log 2>&1
+set -euo pipefail
+
+# Compares the default node layout with the compact reclamation header
+# (bench_compact) and 32-bit tree links (bench_compact_links) at 50M keys
+
+threads=64 # for a many-core server
+# threads=8 # for a laptop
+
+# guard against CRLF endings
+if grep -q $'\r' "$0"; then
+  echo "ERROR: Script has Windows CRLF endings. Run: sed -i 's/\r$//' $0" >&2
+  exit 1
+fi
+
+# project root
+cd "$(dirname "$0")/.." || { echo "Failed to navigate to project root"; exit 1; }
+
+DATA_DIR="$(pwd)/Data"
+SCOT_DIR="SCOT"
+mkdir -p "$DATA_DIR"
+output_file="$DATA_DIR/tree_compact_results.txt"
+
+# build
+cd "$SCOT_DIR" || { echo "Failed to enter $SCOT_DIR"; exit 1; }
+if make -n clean &>/dev/null; then make clean; else echo "Skipping make clean (no target)"; fi
+make bench bench_compact bench_compact_links
+cd ..
+
+schemes=(EBR HP HPO IBR HE HYALINE NR)
+binaries=(bench bench_compact bench_compact_links)
+
+{
+  echo "Scheme, Layout, Ops/sec, memory_usage, rss"
+  for scheme in "${schemes[@]}"; do
+    for binary in "${binaries[@]}"; do
+      log="$(./SCOT/$binary tree 10 50000000 1 50 25 25 "$scheme" "$threads" --arena 2>&1)"
+      median="$(printf "%s\n" "$log" | sed -n '/MEDIAN RESULT/,$p')"
+      ops="$(printf "%s\n" "$median" | awk '/^Ops\/sec = /{print $3; exit}')"
+      mem="$(printf "%s\n" "$median" | awk '/^memory_usage = /{print $3; exit}')"
+      rss="$(printf "%s\n" "$median" | awk '/^rss = /{print $3; exit}')"
+      echo "$scheme, $binary, ${ops:-0}, ${mem:-0}, ${rss:-0}"
+    done
+  done
+} | tee "$output_file"
@@ -3,10 +3,6 @@
 exec >run.log 2>&1
 set -euo pipefail
 
-# -------- fixed thread list --------
-threads=(1 16 32 64 128 256 384) # for a many-core server
-# threads=(1 4 8 12 16 24 32) # for a laptop
-
 # guard against CRLF endings
 if grep -q $'\r' "$0"; then
   echo "ERROR: Script has Windows CRLF endings. Run: sed -i 's/\r$//' $0" >&2
@@ -34,6 +30,16 @@ if make -n clean &>/dev/null; then make clean; else echo "Skipping make clean (n
 make all
 cd ..
 
+# thread counts from the machine topology: 1, one core, one socket, all cores, all hardware threads
+# each as threads:pin, so that every point keeps the placement the sweep gives it
+points=($(./SCOT/bench --list-points))
+threads=()
+declare -A PIN
+for point in "${points[@]}"; do
+  threads+=("${point%%:*}")
+  PIN["${point%%:*}"]="${point#*:}"
+done
+
 commands=(
     './SCOT/bench listlf 10 512 1 50 25 25 EBR'
     './SCOT/bench listlf 10 512 1 50 25 25 HP'
@@ -178,7 +184,7 @@ for cmd in "${commands[@]}"; do
       declare -A OPS_BUCKET MEM_BUCKET
       for cls in "${classes[@]}"; do OPS_BUCKET["$cls"]=""; MEM_BUCKET["$cls"]=""; done
 
-      per_thread_cmd="$base_cmd $t"
+      per_thread_cmd="$base_cmd $t --pin=${PIN[$t]}"
       for ((i=1;i<=runs;i++)); do
         log="$tmp_root/t${t}_run_${i}_${category}_${element_size}_${reclamation}.log"
         eval "$per_thread_cmd" > "$log" 2>&1
@@ -249,7 +255,7 @@ for cmd in "${commands[@]}"; do
       done
     done
 
-    # final CSV with medians per class/thread (for our fixed thread list)
+    # final CSV with medians per class/thread (for the topology thread list)
     echo
     echo "FINAL RESULTS (FOR CHARTS):"
     echo
@@ -0,0 +1,48 @@
+#!/bin/bash
+
+exec >run_openloop.log 2>&1
+set -euo pipefail
+
+# Open loop: sweep the offered load (Poisson arrivals) and record achieved
+# throughput and latency from the intended start. The saturation knee is
+# where achieved falls below offered and the tail latency takes off.
+
+# guard against CRLF endings
+if grep -q $'\r' "$0"; then
+  echo "ERROR: Script has Windows CRLF endings. Run: sed -i 's/\r$//' $0" >&2
+  exit 1
+fi
+
+# project root
+cd "$(dirname "$0")/.." || { echo "Failed to navigate to project root"; exit 1; }
+
+DATA_DIR="$(pwd)/Data"
+SCOT_DIR="SCOT"
+mkdir -p "$DATA_DIR"
+output_file="$DATA_DIR/tree_openloop_results.txt"
+
+# build
+cd "$SCOT_DIR" || { echo "Failed to enter $SCOT_DIR"; exit 1; }
+if make -n clean &>/dev/null; then make clean; else echo "Skipping make clean (no target)"; fi
+make bench
+cd ..
+
+schemes=(EBR HP HPO IBR HE HYALINE NR)
+threads="$(nproc)"
+rates=(1000000 2000000 4000000 8000000 16000000 32000000 64000000 128000000)
+
+{
+  echo "Scheme, Threads, Offered, Ops/sec, late_percent, search_p50_ns, search_p99_ns, search_p99.9_ns"
+  for scheme in "${schemes[@]}"; do
+    for rate in "${rates[@]}"; do
+      log="$(./SCOT/bench tree 10 100000 3 50 25 25 "$scheme" "$threads" --rate="$rate" 2>&1)"
+      median="$(printf "%s\n" "$log" | sed -n '/MEDIAN RESULT/,$p')"
+      ops="$(printf "%s\n" "$median" | awk '/^Ops\/sec = /{print $3; exit}')"
+      late="$(printf "%s\n" "$median" | awk '/^offered = /{sub("%", "", $9); print $9; exit}')"
+      p50="$(printf "%s\n" "$median" | awk '/^latency_ns search:/{print $5; exit}')"
+      p99="$(printf "%s\n" "$median" | awk '/^latency_ns search:/{print $8; exit}')"
+      p999="$(printf "%s\n" "$median" | awk '/^latency_ns search:/{print $11; exit}')"
+      echo "$scheme, $threads, $rate, ${ops:-0}, ${late:-0}, ${p50:-0}, ${p99:-0}, ${p999:-0}"
+    done
+  done
+} | tee "$output_file"
@@ -0,0 +1,50 @@
+#!/bin/bash
+
+exec >run_oversub.log 2>&1
+set -euo pipefail
+
+# Oversubscription: 2x, 4x and 8x as many threads as online CPUs, with
+# and without sched_yield() injected in the middle of operations
+
+# guard against CRLF endings
+if grep -q $'\r' "$0"; then
+  echo "ERROR: Script has Windows CRLF endings. Run: sed -i 's/\r$//' $0" >&2
+  exit 1
+fi
+
+# project root
+cd "$(dirname "$0")/.." || { echo "Failed to navigate to project root"; exit 1; }
+
+DATA_DIR="$(pwd)/Data"
+SCOT_DIR="SCOT"
+mkdir -p "$DATA_DIR"
+output_file="$DATA_DIR/tree_oversub_results.txt"
+
+# build
+cd "$SCOT_DIR" || { echo "Failed to enter $SCOT_DIR"; exit 1; }
+if make -n clean &>/dev/null; then make clean; else echo "Skipping make clean (no target)"; fi
+make bench
+cd ..
+
+schemes=(EBR HP HPO IBR HE HYALINE NR)
+factors=(2 4 8)
+yields=("" "--yield=16")
+
+{
+  echo "Scheme, Factor, Threads, Yield, Ops/sec, memory_usage, search_p99_ns, search_p99.9_ns"
+  for scheme in "${schemes[@]}"; do
+    for factor in "${factors[@]}"; do
+      for yield in "${yields[@]}"; do
+        log="$(./SCOT/bench tree 10 100000 1 50 25 25 "$scheme" --oversub="$factor" $yield 2>&1)"
+        median="$(printf "%s\n" "$log" | sed -n '/MEDIAN RESULT/,$p')"
+        # Large factors are capped at the 384 threads the schemes support
+        nthreads="$(printf "%s\n" "$log" | sed -n 's/.*numThreads=\([0-9]*\).*/\1/p' | head -1)"
+        ops="$(printf "%s\n" "$median" | awk '/^Ops\/sec = /{print $3; exit}')"
+        mem="$(printf "%s\n" "$median" | awk '/^memory_usage = /{print $3; exit}')"
+        p99="$(printf "%s\n" "$median" | awk '/^latency_ns search:/{print $8; exit}')"
+        p999="$(printf "%s\n" "$median" | awk '/^latency_ns search:/{print $11; exit}')"
+        echo "$scheme, $factor, ${nthreads:-0}, ${yield:-none}, ${ops:-0}, ${mem:-0}, ${p99:-0}, ${p999:-0}"
+      done
+    done
+  done
+} | tee "$output_file"
@@ -0,0 +1,46 @@
+#!/bin/bash
+
+exec >run_phases.log 2>&1
+set -euo pipefail
+
+# Phase-changing workload: start empty, grow to the full key range, churn,
+# delete everything and grow again, in one run. The grow and shrink phases
+# end at their target size rather than after a fixed time. Records throughput and
+# unreclaimed nodes (at the end of each phase and at the peak) per phase;
+# the mass delete is where retired lists and lagging epochs show up.
+
+# guard against CRLF endings
+if grep -q $'\r' "$0"; then
+  echo "ERROR: Script has Windows CRLF endings. Run: sed -i 's/\r$//' $0" >&2
+  exit 1
+fi
+
+# project root
+cd "$(dirname "$0")/.." || { echo "Failed to navigate to project root"; exit 1; }
+
+DATA_DIR="$(pwd)/Data"
+SCOT_DIR="SCOT"
+mkdir -p "$DATA_DIR"
+output_file="$DATA_DIR/tree_phases_results.txt"
+
+# build
+cd "$SCOT_DIR" || { echo "Failed to enter $SCOT_DIR"; exit 1; }
+if make -n clean &>/dev/null; then make clean; else echo "Skipping make clean (no target)"; fi
+make bench
+cd ..
+
+schemes=(EBR HP HPO IBR HE HYALINE NR)
+threads="$(nproc)"
+phases="grow:until=1000000,churn:10,shrink:until=0,grow:until=1000000"
+
+{
+  echo "Scheme, Threads, Phase, Mix, Ops/sec, unreclaimed, peak_unreclaimed, size, ms"
+  for scheme in "${schemes[@]}"; do
+    log="$(./SCOT/bench tree 10 1000000 3 50 25 25 "$scheme" "$threads" --prefill=0 --phases="$phases" 2>&1)"
+    printf "%s\n" "$log" | sed -n '/MEDIAN RESULT/,$p' | awk -v scheme="$scheme" -v threads="$threads" '
+      /^phase / {
+        mix=$4; sub(/^\(/, "", mix); sub(/,$/, "", mix)
+        print scheme ", " threads ", " $2 " " $3 ", " mix ", " $8 ", " $11 ", " $14 ", " $17 ", " $20
+      }'
+  done
+} | tee "$output_file"
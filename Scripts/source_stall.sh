@@ -0,0 +1,46 @@
+#!/bin/bash
+
+exec >run_stall.log 2>&1
+set -euo pipefail
+
+# Robustness under stalled readers: 2 threads sleep 100 ms inside an
+# operation every 500 ms while the rest keep updating the tree. The time
+# series (throughput and unreclaimed nodes every 50 ms) of every scheme
+# goes to Data/tree_stall_<scheme>.csv
+
+threads=64 # for a many-core server
+# threads=8 # for a laptop
+
+# guard against CRLF endings
+if grep -q $'\r' "$0"; then
+  echo "ERROR: Script has Windows CRLF endings. Run: sed -i 's/\r$//' $0" >&2
+  exit 1
+fi
+
+# project root
+cd "$(dirname "$0")/.." || { echo "Failed to navigate to project root"; exit 1; }
+
+DATA_DIR="$(pwd)/Data"
+SCOT_DIR="SCOT"
+mkdir -p "$DATA_DIR"
+output_file="$DATA_DIR/tree_stall_results.txt"
+
+# build
+cd "$SCOT_DIR" || { echo "Failed to enter $SCOT_DIR"; exit 1; }
+if make -n clean &>/dev/null; then make clean; else echo "Skipping make clean (no target)"; fi
+make bench
+cd ..
+
+schemes=(EBR HP HPO IBR HE HYALINE)
+
+{
+  echo "Scheme, Ops/sec, memory_usage, stalls"
+  for scheme in "${schemes[@]}"; do
+    log="$(./SCOT/bench tree 10 100000 1 50 25 25 "$scheme" "$threads" --stall=2:500:100 --sample=50:"$DATA_DIR/tree_stall_$scheme.csv" 2>&1)"
+    median="$(printf "%s\n" "$log" | sed -n '/MEDIAN RESULT/,$p')"
+    ops="$(printf "%s\n" "$median" | awk '/^Ops\/sec = /{print $3; exit}')"
+    mem="$(printf "%s\n" "$median" | awk '/^memory_usage = /{print $3; exit}')"
+    stalls="$(printf "%s\n" "$log" | awk '/^stalls = /{print $3; exit}')"
+    echo "$scheme, ${ops:-0}, ${mem:-0}, ${stalls:-0}"
+  done
+} | tee "$output_file"